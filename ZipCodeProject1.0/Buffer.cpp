@@ -4,9 +4,63 @@
  */
 
  #include "Buffer.h"
+ #include <thread>
 
  using namespace std;
  
+ /**
+  * @brief Writes a message about a line to cerr in one piece, so lines from different threads do not interleave.
+  */
+ static void report(const string& message, const string& line, const string& detail = "") {
+     cerr << (message + line + detail + "\n");
+ }
+ 
+ /**
+  * @brief Parses one CSV line into a record, printing warnings and errors as it goes.
+  * @return True if the line holds a valid record, false otherwise.
+  */
+ static bool parseCSVLine(const string& line, ZipCodeRecord& record) {
+     stringstream ss(line);
+     string zip, lat, lon;
+     vector<string> values;
+     string token;
+ 
+     while (getline(ss, token, ',')) {
+         values.push_back(token);
+     }
+ 
+     if (values.size() != 6) {
+         report("Error: Incorrect number of columns on line: ", line);
+         return false;
+     }
+ 
+     zip = values[0];
+     record.place_name = values[1];
+     record.state = values[2];
+     record.county = values[3];
+     lat = values[4];
+     lon = values[5];
+ 
+     if (record.county.empty()) {
+         report("Warning: Missing county on line: ", line);
+     }
+ 
+     if (zip.empty() || record.state.empty() || lat.empty() || lon.empty()) {
+         report("Error: Missing critical values on line: ", line);
+         return false;
+     }
+ 
+     try {
+         record.zip_code = stoi(zip);
+         record.lat = stod(lat);
+         record.lon = stod(lon);
+     } catch (const exception& e) {
+         report("Error parsing numeric values on line: ", line, string(" - ") + e.what());
+         return false;
+     }
+     return true;
+ }
+ 
  bool Buffer::readCSV(const string& filename, vector<ZipCodeRecord>& records) {
      ifstream file(filename);
      if (!file.is_open()) {
@@ -18,56 +72,125 @@
      getline(file, line); // Skip header
  
      while (getline(file, line)) {
-         stringstream ss(line);
          ZipCodeRecord record;
-         string zip, lat, lon;
-         vector<string> values;
-         string token;
- 
-         while (getline(ss, token, ',')) {
-             values.push_back(token);
+         if (parseCSVLine(line, record)) {
+             records.push_back(record);
          }
+     }
  
-         if (values.size() != 6) {
-             cerr << "Error: Incorrect number of columns on line: " << line << endl;
-             continue;
-         }
+     file.close();
+     return true;
+ }
  
-         zip = values[0];
-         record.place_name = values[1];
-         record.state = values[2];
-         record.county = values[3];
-         lat = values[4];
-         lon = values[5];
+ void Buffer::processRecords(const vector<ZipCodeRecord>& records, map<string, vector<ZipCodeRecord>>& state_map) {
+     for (const auto& record : records) {
+         state_map[record.state].push_back(record);
+     }
+ }
  
-         if (record.county.empty()) {
-             cerr << "Warning: Missing county on line: " << line << endl;
+ void LocationExtreme::offer(double coordinate, int zip, const string& place, bool smaller, bool byPlaceName) {
+     if (found) {
+         if (coordinate != value) {
+             if ((coordinate < value) != smaller) {
+                 return;
+             }
+         } else {
+             int order = byPlaceName ? place.compare(place_name) : 0;
+             if (order > 0 || (order == 0 && zip >= zip_code)) {
+                 return;
+             }
          }
+     }
+     found = true;
+     value = coordinate;
+     zip_code = zip;
+     place_name = place;
+ }
  
-         if (zip.empty() || record.state.empty() || lat.empty() || lon.empty()) {
-             cerr << "Error: Missing critical values on line: " << line << endl;
-             continue;
-         }
+ void StateExtremes::add(const ZipCodeRecord& record, bool byPlaceName) {
+     east.offer(record.lon, record.zip_code, record.place_name, true, byPlaceName);
+     west.offer(record.lon, record.zip_code, record.place_name, false, byPlaceName);
+     north.offer(record.lat, record.zip_code, record.place_name, false, byPlaceName);
+     south.offer(record.lat, record.zip_code, record.place_name, true, byPlaceName);
+ }
  
-         try {
-             record.zip_code = stoi(zip);
-             record.lat = stod(lat);
-             record.lon = stod(lon);
-         } catch (const exception& e) {
-             cerr << "Error parsing numeric values on line: " << line << " - " << e.what() << endl;
-             continue;
-         }
+ void StateExtremes::merge(const StateExtremes& other, bool byPlaceName) {
+     if (!other.east.found) {
+         return;  // All four are set by the same first record
+     }
+     east.offer(other.east.value, other.east.zip_code, other.east.place_name, true, byPlaceName);
+     west.offer(other.west.value, other.west.zip_code, other.west.place_name, false, byPlaceName);
+     north.offer(other.north.value, other.north.zip_code, other.north.place_name, false, byPlaceName);
+     south.offer(other.south.value, other.south.zip_code, other.south.place_name, true, byPlaceName);
+ }
+ 
+ bool Buffer::readStateExtremes(const string& filename, bool byPlaceName, map<string, StateExtremes>& extremes,
+                                unsigned threadCount) {
+     ifstream file(filename, ios::binary);
+     if (!file.is_open()) {
+         cerr << "Error: Could not open the file " << filename << endl;
+         return false;
+     }
+ 
+     string line;
+     getline(file, line); // Skip header
+     streamoff start = file.tellg();
+     file.seekg(0, ios::end);
+     streamoff size = file.tellg();
+     if (start < 0) {
+         start = size;
+     }
  
-         records.push_back(record);
+     // Small ranges are not worth a thread
+     const streamoff MIN_RANGE_SIZE = 256 * 1024;
+     if (threadCount == 0) {
+         threadCount = max(1u, thread::hardware_concurrency());
      }
+     size_t rangeCount = min<streamoff>(threadCount, max<streamoff>(1, (size - start) / MIN_RANGE_SIZE));
  
+     // Each range starts at the beginning of a line
+     vector<streamoff> bounds(rangeCount + 1, size);
+     bounds[0] = start;
+     for (size_t i = 1; i < rangeCount; i++) {
+         streamoff pos = max(bounds[i - 1], start + (size - start) * static_cast<streamoff>(i) / static_cast<streamoff>(rangeCount));
+         file.clear();
+         file.seekg(pos - 1);
+         if (file.get() != '\n') {
+             getline(file, line);
+         }
+         pos = file.tellg();
+         bounds[i] = pos < 0 ? size : pos;
+     }
      file.close();
-     return true;
- }
  
- void Buffer::processRecords(const vector<ZipCodeRecord>& records, map<string, vector<ZipCodeRecord>>& state_map) {
-     for (const auto& record : records) {
-         state_map[record.state].push_back(record);
+     vector<map<string, StateExtremes>> partials(rangeCount);
+     auto scanRange = [&](size_t r) {
+         ifstream range(filename, ios::binary);
+         range.seekg(bounds[r]);
+         streamoff pos = bounds[r];
+         string rangeLine;
+         ZipCodeRecord record;
+         while (pos < bounds[r + 1] && getline(range, rangeLine)) {
+             pos += rangeLine.size() + 1;
+             if (parseCSVLine(rangeLine, record)) {
+                 partials[r][record.state].add(record, byPlaceName);
+             }
+         }
+     };
+ 
+     vector<thread> workers;
+     for (size_t r = 1; r < rangeCount; r++) {
+         workers.emplace_back(scanRange, r);
      }
+     scanRange(0);
+     for (auto& worker : workers) {
+         worker.join();
+     }
+ 
+     for (const auto& states : partials) {
+         for (const auto& entry : states) {
+             extremes[entry.first].merge(entry.second, byPlaceName);
+         }
+     }
+     return true;
  }
- 
\ No newline at end of file
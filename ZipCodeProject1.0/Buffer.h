@@ -33,6 +33,55 @@ struct ZipCodeRecord {
     double lon;           ///< Longitude coordinate of the location.
 };
 
+/**
+ * @struct LocationExtreme
+ * @brief The record found so far at one extreme (e.g. easternmost) of a state.
+ */
+struct LocationExtreme {
+    bool found = false;   ///< Whether any record has been seen.
+    double value = 0;     ///< Coordinate of the record (longitude or latitude).
+    int zip_code = 0;     ///< zip code of the record.
+    string place_name;    ///< City or place name of the record.
+
+    /**
+     * @brief Replaces the extreme if a candidate beats it.
+     * @param coordinate Coordinate of the candidate.
+     * @param zip zip code of the candidate.
+     * @param place Place name of the candidate.
+     * @param smaller True if the smaller coordinate wins, false if the larger one does.
+     * @param byPlaceName True to break coordinate ties by place name, false by zip code.
+     *
+     * Ties are broken by the sort key, as if the records had been sorted first and the
+     * first one kept, so the result does not depend on the order records arrive in.
+     */
+    void offer(double coordinate, int zip, const string& place, bool smaller, bool byPlaceName);
+};
+
+/**
+ * @struct StateExtremes
+ * @brief Fixed-size accumulator of the four extreme locations of one state.
+ */
+struct StateExtremes {
+    LocationExtreme east;   ///< Smallest longitude.
+    LocationExtreme west;   ///< Largest longitude.
+    LocationExtreme north;  ///< Largest latitude.
+    LocationExtreme south;  ///< Smallest latitude.
+
+    /**
+     * @brief Folds one record into the extremes.
+     * @param record The record.
+     * @param byPlaceName True to break ties by place name, false by zip code.
+     */
+    void add(const ZipCodeRecord& record, bool byPlaceName);
+
+    /**
+     * @brief Folds the extremes of another part of the file into these.
+     * @param other Extremes of the same state from another part.
+     * @param byPlaceName True to break ties by place name, false by zip code.
+     */
+    void merge(const StateExtremes& other, bool byPlaceName);
+};
+
 /**
  * @class Buffer
  * @brief A class to handle reading, processing, and validating zip code data.
@@ -58,6 +107,21 @@ public:
      * This function groups zip code records by state into a map for easy retrieval.
      */
     void processRecords(const vector<ZipCodeRecord>& records, map<string, vector<ZipCodeRecord>>& state_map);
+
+    /**
+     * @brief Finds the extreme locations of each state in one pass over a CSV file.
+     * @param filename The name of the CSV file to read.
+     * @param byPlaceName True to break coordinate ties by place name, false by zip code.
+     * @param extremes A map to store the extremes of each state.
+     * @param threadCount Number of threads, or 0 to use every hardware thread.
+     * @return True if the file is read successfully, false otherwise.
+     *
+     * No records are kept: the file is split into one line-aligned byte range per thread, each thread reads
+     * its range into its own per-state accumulators, and the accumulators are merged at the end. Time is
+     * linear in the file size and memory is proportional to the number of states.
+     */
+    bool readStateExtremes(const string& filename, bool byPlaceName, map<string, StateExtremes>& extremes,
+                           unsigned threadCount = 0);
 };
 
 #endif // BUFFER_H
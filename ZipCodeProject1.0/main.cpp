@@ -2,18 +2,17 @@
  * @file main.cpp
  * @brief Main program for processing zip code data and generating reports.
  *
- * This program reads zip code data from a CSV file (us_postal_codes.csv),
- * sorts it based on user selection (Zip Code or Place Name), and then organizes
- * the data by state. It outputs the easternmost, westernmost, northernmost,
- * and southernmost locations using either Zip Codes or Place Names.
+ * This program reads zip code data from a CSV file (us_postal_codes.csv) and, in
+ * one streaming pass, finds the easternmost, westernmost, northernmost, and
+ * southernmost locations of each state. It outputs them using either Zip Codes or
+ * Place Names, per user selection; locations at the same coordinate are decided by
+ * that choice, as if the records had been sorted by it.
  */
 
 #include <iostream>
 #include <fstream>
-#include <vector>
 #include <map>
 #include <iomanip>
-#include <algorithm>
 #include "Buffer.h"
 
 using namespace std;
@@ -23,9 +22,8 @@ using namespace std;
  * @return 0 on successful execution, -1 on error.
  */
 int main() {
-    vector<ZipCodeRecord> records;
     Buffer buffer;
-    map<string, vector<ZipCodeRecord>> state_map;
+    map<string, StateExtremes> state_map;
 
     string filename = "us_postal_codes.csv";
 
@@ -42,25 +40,12 @@ int main() {
         cout << "Invalid choice! Please enter 'Z' for Zip Code or 'P' for Place Name.\n";
     }
 
-    // Read CSV file
-    if (!buffer.readCSV(filename, records)) {
+    // Read CSV file, keeping only the extremes of each state
+    if (!buffer.readStateExtremes(filename, sortChoice == 'P', state_map)) {
         cerr << "Error: Unable to read CSV file: " << filename << endl;
         return -1;
     }
 
-    // Sort data based on user choice
-    if (sortChoice == 'Z') {
-        sort(records.begin(), records.end(), [](const ZipCodeRecord& a, const ZipCodeRecord& b) {
-            return a.zip_code < b.zip_code;
-        });
-    } else {
-        sort(records.begin(), records.end(), [](const ZipCodeRecord& a, const ZipCodeRecord& b) {
-            return a.place_name < b.place_name;
-        });
-    }
-
-    buffer.processRecords(records, state_map);
-
     ofstream outfile_txt("SortedLocations.txt");
     ofstream outfile_csv("SortedLocations.csv");
 
@@ -79,40 +64,17 @@ int main() {
 
     outfile_csv << "State,Easternmost,Westernmost,Northernmost,Southernmost\n";
 
-    // Process each state and determine extreme locations
+    // Write the extreme locations of each state
     for (const auto& entry : state_map) {
         const string& state = entry.first;
-        const vector<ZipCodeRecord>& zipRecords = entry.second;
-
-        string eastPlace, westPlace, northPlace, southPlace;
-        int eastZip, westZip, northZip, southZip;
-        double minLon = numeric_limits<double>::max();
-        double maxLon = numeric_limits<double>::lowest();
-        double maxLat = numeric_limits<double>::lowest();
-        double minLat = numeric_limits<double>::max();
-
-        for (const auto& record : zipRecords) {
-            if (record.lon < minLon) {
-                minLon = record.lon;
-                eastZip = record.zip_code;
-                eastPlace = record.place_name;
-            }
-            if (record.lon > maxLon) {
-                maxLon = record.lon;
-                westZip = record.zip_code;
-                westPlace = record.place_name;
-            }
-            if (record.lat > maxLat) {
-                maxLat = record.lat;
-                northZip = record.zip_code;
-                northPlace = record.place_name;
-            }
-            if (record.lat < minLat) {
-                minLat = record.lat;
-                southZip = record.zip_code;
-                southPlace = record.place_name;
-            }
-        }
+        const StateExtremes& extremes = entry.second;
+
+        int eastZip = extremes.east.zip_code, westZip = extremes.west.zip_code;
+        int northZip = extremes.north.zip_code, southZip = extremes.south.zip_code;
+        const string& eastPlace = extremes.east.place_name;
+        const string& westPlace = extremes.west.place_name;
+        const string& northPlace = extremes.north.place_name;
+        const string& southPlace = extremes.south.place_name;
 
         if (sortChoice == 'Z') {
             // Output using zip Codes
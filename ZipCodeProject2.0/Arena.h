@@ -0,0 +1,175 @@
+/**
+ * @file Arena.h
+ * @brief Definition of the MonotonicArena and StringInterner classes for bulk record loads
+ *
+ * MonotonicArena hands out memory from large chunks and frees it all at once.
+ * StringInterner keeps one copy of each distinct string in an arena, so
+ * loading millions of records allocates per distinct place, state or county
+ * name rather than per field.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @class MonotonicArena
+ * @brief Bump allocator whose memory is only released all at once
+ */
+class MonotonicArena {
+private:
+    static constexpr size_t MAX_CHUNK_SIZE = 1 << 20;  ///< Chunks stop doubling at this size
+
+    std::vector<std::unique_ptr<char[]>> chunks;  ///< Every chunk allocated so far
+    char* current;                                ///< Next free byte in the newest chunk
+    size_t remaining;                             ///< Free bytes left in the newest chunk
+    size_t nextChunkSize;                         ///< Size of the next chunk to allocate
+    size_t initialChunkSize;                      ///< Size of the first chunk
+    size_t used;                                  ///< Bytes handed out since the last release
+
+    /**
+     * @brief Allocate a new chunk big enough for a request
+     * @param size Bytes the chunk must hold (plus alignment slack)
+     */
+    void grow(size_t size) {
+        size_t chunkSize = nextChunkSize > size ? nextChunkSize : size;
+        chunks.emplace_back(new char[chunkSize]);
+        current = chunks.back().get();
+        remaining = chunkSize;
+        if (nextChunkSize < MAX_CHUNK_SIZE) {
+            nextChunkSize *= 2;
+        }
+    }
+
+public:
+    /**
+     * @brief Constructor
+     * @param chunkSize Size of the first chunk in bytes (later chunks double up to 1 MB)
+     */
+    explicit MonotonicArena(size_t chunkSize = 1 << 16)
+        : current(nullptr), remaining(0), nextChunkSize(chunkSize > 0 ? chunkSize : 1),
+          initialChunkSize(chunkSize > 0 ? chunkSize : 1), used(0) {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    /**
+     * @brief Allocate uninitialized memory
+     * @param size Number of bytes
+     * @param alignment Required alignment (a power of two)
+     * @return Pointer valid until release() or destruction
+     */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        size_t padding = current ? (alignment - reinterpret_cast<uintptr_t>(current) % alignment) % alignment : 0;
+        if (!current || padding + size > remaining) {
+            grow(size + alignment);
+            padding = (alignment - reinterpret_cast<uintptr_t>(current) % alignment) % alignment;
+        }
+        char* result = current + padding;
+        current += padding + size;
+        remaining -= padding + size;
+        used += size;
+        return result;
+    }
+
+    /**
+     * @brief Copy a string into the arena
+     * @param text The string to copy
+     * @return A view of the copy, valid until release() or destruction
+     */
+    std::string_view copy(std::string_view text) {
+        if (text.empty()) {
+            return std::string_view();
+        }
+        char* bytes = static_cast<char*>(allocate(text.size(), 1));
+        std::memcpy(bytes, text.data(), text.size());
+        return std::string_view(bytes, text.size());
+    }
+
+    /**
+     * @brief Free every allocation at once
+     */
+    void release() {
+        chunks.clear();
+        current = nullptr;
+        remaining = 0;
+        nextChunkSize = initialChunkSize;
+        used = 0;
+    }
+
+    /**
+     * @brief Get the number of bytes handed out
+     * @return Bytes allocated since the last release
+     */
+    size_t bytesUsed() const { return used; }
+
+    /**
+     * @brief Get the number of chunks held
+     * @return The number of underlying heap allocations
+     */
+    size_t chunkCount() const { return chunks.size(); }
+};
+
+/**
+ * @class StringInterner
+ * @brief Stores each distinct string once and hands out stable views of it
+ */
+class StringInterner {
+private:
+    MonotonicArena arena;                         ///< Storage for the string bytes
+    std::unordered_set<std::string_view> strings; ///< Views of every stored string
+
+public:
+    /**
+     * @brief Constructor
+     * @param chunkSize Size of the first arena chunk in bytes
+     */
+    explicit StringInterner(size_t chunkSize = 1 << 16) : arena(chunkSize) {}
+
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    /**
+     * @brief Get the stored copy of a string, storing it if new
+     * @param text The string
+     * @return A view valid until release() or destruction; equal strings get the same view
+     */
+    std::string_view intern(std::string_view text) {
+        auto it = strings.find(text);
+        if (it != strings.end()) {
+            return *it;
+        }
+        std::string_view stored = arena.copy(text);
+        strings.insert(stored);
+        return stored;
+    }
+
+    /**
+     * @brief Get the number of distinct strings stored
+     * @return The string count
+     */
+    size_t size() const { return strings.size(); }
+
+    /**
+     * @brief Get the number of bytes of string data stored
+     * @return The byte count
+     */
+    size_t bytesUsed() const { return arena.bytesUsed(); }
+
+    /**
+     * @brief Free every stored string at once (all views become invalid)
+     */
+    void release() {
+        strings.clear();
+        arena.release();
+    }
+};
+
+#endif // ARENA_H
@@ -4,75 +4,281 @@
  */
 
 #include "Buffer.h"
+#include "CSVTokenizer.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <thread>
 
 using namespace std;
 
+/**
+ * @brief Writes an error about a line to cerr in one piece, so lines from different threads do not interleave.
+ */
+static void reportError(const char* message, string_view text) {
+    string report(message);
+    report.append(text.data(), text.size()).push_back('\n');
+    cerr << report;
+}
+
+/**
+ * @brief Parses one length-indicated line into a record whose text fields view the line or the tokenizer.
+ * @return True if the line holds a valid record, false (after printing why) otherwise.
+ */
+static bool parseRecordLine(string_view line, CSVTokenizer& tokenizer, ZipCodeRecord& record) {
+    if (line.size() < 3) {  // Check for valid line format
+        reportError("Error: Malformed record: ", line);
+        return false;
+    }
+
+    string_view recordData = line.substr(3); // The actual CSV record after the 2-digit length and comma
+
+    if (tokenizer.split(recordData) != 6) {
+        reportError("Error: Incorrect number of fields in length-indicated record: ", recordData);
+        return false;
+    }
+
+    // Fill ZipCodeRecord fields
+    if (!CSVTokenizer::parseInt(tokenizer[0], record.zip_code) ||
+        !CSVTokenizer::parseDouble(tokenizer[4], record.lat) ||
+        !CSVTokenizer::parseDouble(tokenizer[5], record.lon)) { // Error catching
+        reportError("Error parsing numeric values in record: ", recordData);
+        return false;
+    }
+    record.place_name = tokenizer[1];
+    record.state = tokenizer[2];
+    record.county = tokenizer[3];
+    return true;
+}
+
 bool Buffer::readLengthIndicatedFile(const string& filename, vector<ZipCodeRecord>& records) {
-    ifstream file(filename);
-    if (!file.is_open()) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
         cerr << "Error: Could not open the length-indicated file " << filename << endl;
         return false;
     }
 
+    CSVLineReader reader(file.data(), file.size());
+    CSVTokenizer tokenizer;
+    string_view line;
+
     int linesToSkip = 15; // Skip the 15 header lines: 8 fixed + 6 fields + 1 primary key line
-    string dummy;
     for (int i = 0; i < linesToSkip; ++i) {
-        getline(file, dummy);
+        reader.nextLine(line);
     }
 
-    string line;
-    while (getline(file, line)) {
-        if (line.size() < 3) {  // Check for valid line format
-            cerr << "Error: Malformed record: " << line << endl;
+    ZipCodeRecord record;
+    while (reader.nextLine(line)) {
+        if (!parseRecordLine(line, tokenizer, record)) {
             continue;
         }
-        
-        string lengthStr = line.substr(0, 2); // Extract first two characters as length
-        int recordLength = stoi(lengthStr); // Convert to length value integer
+        record.place_name = strings.intern(record.place_name);
+        record.state = strings.intern(record.state);
+        record.county = strings.intern(record.county);
 
-        string recordData = line.substr(3); // Extract the actual CSV record after the length is processed
+        records.push_back(record);
+    }
 
-        stringstream ss(recordData);
-        ZipCodeRecord record;
-        string zip, lat, lon;
-        vector<string> values;
-        string token;
+    return true;
+}
 
-        while (getline(ss, token, ',')) {
-            values.push_back(token);
-        }
+void Buffer::processRecords(const vector<ZipCodeRecord>& records, map<string, vector<ZipCodeRecord>>& state_map) {
+    // Count each state first so every vector is allocated exactly once
+    unordered_map<string_view, size_t> counts;
+    for (const auto& record : records) {
+        counts[record.state]++;
+    }
 
-        if (values.size() != 6) {
-            cerr << "Error: Incorrect number of fields in length-indicated record: " << recordData << endl;
-            continue;
+    unordered_map<string_view, vector<ZipCodeRecord>*> groups;
+    for (const auto& entry : counts) {
+        vector<ZipCodeRecord>& group = state_map[string(entry.first)];
+        group.reserve(group.size() + entry.second);
+        groups[entry.first] = &group;
+    }
+
+    for (const auto& record : records) {
+        groups[record.state]->push_back(record);
+    }
+}
+
+void LocationExtreme::offer(double coordinate, int zip, string_view place, bool smaller, bool byPlaceName) {
+    if (found) {
+        if (coordinate != value) {
+            if ((coordinate < value) != smaller) {
+                return;
+            }
+        } else {
+            int order = byPlaceName ? place.compare(place_name) : 0;
+            if (order > 0 || (order == 0 && zip >= zip_code)) {
+                return;
+            }
         }
+    }
+    found = true;
+    value = coordinate;
+    zip_code = zip;
+    place_name.assign(place.data(), place.size());
+}
 
-        // Fill ZipCodeRecord fields
-        zip = values[0];
-        record.place_name = values[1];
-        record.state = values[2];
-        record.county = values[3];
-        lat = values[4];
-        lon = values[5];
-
-        try {
-            record.zip_code = stoi(zip);
-            record.lat = stod(lat);
-            record.lon = stod(lon);
-        } catch (const exception& e) { // Error catching
-            cerr << "Error parsing numeric values in record: " << recordData << " - " << e.what() << endl;
-            continue;
+void StateExtremes::add(const ZipCodeRecord& record, bool byPlaceName) {
+    east.offer(record.lon, record.zip_code, record.place_name, true, byPlaceName);
+    west.offer(record.lon, record.zip_code, record.place_name, false, byPlaceName);
+    north.offer(record.lat, record.zip_code, record.place_name, false, byPlaceName);
+    south.offer(record.lat, record.zip_code, record.place_name, true, byPlaceName);
+}
+
+void StateExtremes::merge(const StateExtremes& other, bool byPlaceName) {
+    if (!other.east.found) {
+        return;  // All four are set by the same first record
+    }
+    east.offer(other.east.value, other.east.zip_code, other.east.place_name, true, byPlaceName);
+    west.offer(other.west.value, other.west.zip_code, other.west.place_name, false, byPlaceName);
+    north.offer(other.north.value, other.north.zip_code, other.north.place_name, false, byPlaceName);
+    south.offer(other.south.value, other.south.zip_code, other.south.place_name, true, byPlaceName);
+}
+
+/**
+ * @brief Splits the records of a mapped length-indicated file into line-aligned ranges, one per thread.
+ * @param bounds Output parameter for the range bounds; range r is [bounds[r], bounds[r + 1]).
+ * @return The number of ranges.
+ */
+static size_t splitRecordRanges(const MappedFile& file, unsigned threadCount, vector<size_t>& bounds) {
+    const char* data = file.data();
+    size_t size = file.size();
+
+    CSVLineReader header(data, size);
+    string_view line;
+    int linesToSkip = 15; // Skip the 15 header lines: 8 fixed + 6 fields + 1 primary key line
+    for (int i = 0; i < linesToSkip; ++i) {
+        header.nextLine(line);
+    }
+    size_t start = header.getOffset();
+
+    // Small ranges are not worth a thread
+    const size_t MIN_RANGE_SIZE = 256 * 1024;
+    if (threadCount == 0) {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+    size_t rangeCount = min<size_t>(threadCount, max<size_t>(1, (size - start) / MIN_RANGE_SIZE));
+
+    // Each range starts at the beginning of a line
+    bounds.assign(rangeCount + 1, size);
+    bounds[0] = start;
+    for (size_t i = 1; i < rangeCount; i++) {
+        size_t pos = max(bounds[i - 1], start + (size - start) * i / rangeCount);
+        if (pos > 0 && pos < size && data[pos - 1] != '\n') {
+            const void* newline = memchr(data + pos, '\n', size - pos);
+            pos = newline ? static_cast<const char*>(newline) - data + 1 : size;
         }
+        bounds[i] = pos;
+    }
+    return rangeCount;
+}
 
-        records.push_back(record);
+/**
+ * @brief Runs scanRange(r) for every range, range 0 on the calling thread and the others on their own.
+ */
+template <typename ScanRange>
+static void runRanges(size_t rangeCount, ScanRange scanRange) {
+    vector<thread> workers;
+    for (size_t r = 1; r < rangeCount; r++) {
+        workers.emplace_back(scanRange, r);
+    }
+    scanRange(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+bool Buffer::readStateExtremes(const string& filename, bool byPlaceName, map<string, StateExtremes>& extremes,
+                               unsigned threadCount) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        cerr << "Error: Could not open the length-indicated file " << filename << endl;
+        return false;
     }
+    const char* data = file.data();
+    vector<size_t> bounds;
+    size_t rangeCount = splitRecordRanges(file, threadCount, bounds);
+
+    vector<map<string, StateExtremes, less<>>> partials(rangeCount);
+    runRanges(rangeCount, [&](size_t r) {
+        CSVLineReader reader(data + bounds[r], bounds[r + 1] - bounds[r]);
+        CSVTokenizer tokenizer;
+        ZipCodeRecord record;
+        string_view rangeLine;
+        map<string, StateExtremes, less<>>& states = partials[r];
+        auto current = states.end();
+        while (reader.nextLine(rangeLine)) {
+            if (!parseRecordLine(rangeLine, tokenizer, record)) {
+                continue;
+            }
+            // Records of a state tend to be adjacent, so the last state found is checked first
+            if (current == states.end() || current->first != record.state) {
+                current = states.find(record.state);
+                if (current == states.end()) {
+                    current = states.emplace(string(record.state), StateExtremes()).first;
+                }
+            }
+            current->second.add(record, byPlaceName);
+        }
+    });
 
-    file.close();
+    for (const auto& states : partials) {
+        for (const auto& entry : states) {
+            extremes[entry.first].merge(entry.second, byPlaceName);
+        }
+    }
     return true;
 }
 
-void Buffer::processRecords(const vector<ZipCodeRecord>& records, map<string, vector<ZipCodeRecord>>& state_map) {
-    for (const auto& record : records) {
-        state_map[record.state].push_back(record);
+bool Buffer::readStateHulls(const string& filename, StateHulls& hulls, unsigned threadCount) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        cerr << "Error: Could not open the length-indicated file " << filename << endl;
+        return false;
+    }
+    const char* data = file.data();
+    vector<size_t> bounds;
+    size_t rangeCount = splitRecordRanges(file, threadCount, bounds);
+
+    // Each thread reduces its range's locations to one hull per state
+    vector<map<string, vector<StateHulls::Vertex>, less<>>> partials(rangeCount);
+    runRanges(rangeCount, [&](size_t r) {
+        CSVLineReader reader(data + bounds[r], bounds[r + 1] - bounds[r]);
+        CSVTokenizer tokenizer;
+        ZipCodeRecord record;
+        string_view rangeLine;
+        map<string, vector<StateHulls::Vertex>, less<>>& states = partials[r];
+        auto current = states.end();
+        while (reader.nextLine(rangeLine)) {
+            if (!parseRecordLine(rangeLine, tokenizer, record)) {
+                continue;
+            }
+            if (current == states.end() || current->first != record.state) {
+                current = states.find(record.state);
+                if (current == states.end()) {
+                    current = states.emplace(string(record.state), vector<StateHulls::Vertex>()).first;
+                }
+            }
+            current->second.push_back({record.lat, StateHulls::unwrapLongitude(record.lon), record.zip_code});
+        }
+        for (auto& entry : states) {
+            StateHulls::reduceToHull(entry.second);
+        }
+    });
+
+    // The hull of a state is the hull of its partial hulls
+    map<string, vector<StateHulls::Vertex>> merged;
+    for (const auto& states : partials) {
+        for (const auto& entry : states) {
+            vector<StateHulls::Vertex>& points = merged[entry.first];
+            points.insert(points.end(), entry.second.begin(), entry.second.end());
+        }
     }
+    hulls.clear();
+    for (auto& entry : merged) {
+        StateHulls::reduceToHull(entry.second);
+        hulls.setHull(entry.first, move(entry.second));
+    }
+    return true;
 }
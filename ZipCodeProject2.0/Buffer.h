@@ -13,31 +13,89 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <limits>
 #include <map>
+#include "Arena.h"
+#include "StateHulls.h"
 
 using namespace std;
 
 /**
  * @struct ZipCodeRecord
  * @brief Structure to hold zip code data for a given location.
+ *
+ * The text fields are views of strings interned by the Buffer that read the
+ * record, and stay valid until that Buffer is destroyed or released.
  */
 struct ZipCodeRecord {
     int zip_code;         ///< Zip code of the location.
-    string place_name;    ///< City/location name.
-    string state;         ///< Two-letter state abbreviation.
-    string county;        ///< County name (can be empty).
+    string_view place_name; ///< City/location name.
+    string_view state;    ///< Two-letter state abbreviation.
+    string_view county;   ///< County name (can be empty).
     double lat;           ///< Latitude coordinate of the location.
     double lon;           ///< Longitude coordinate of the location.
 };
 
+/**
+ * @struct LocationExtreme
+ * @brief The record found so far at one extreme (e.g. easternmost) of a state.
+ */
+struct LocationExtreme {
+    bool found = false;   ///< Whether any record has been seen.
+    double value = 0;     ///< Coordinate of the record (longitude or latitude).
+    int zip_code = 0;     ///< Zip code of the record.
+    string place_name;    ///< City/location name of the record.
+
+    /**
+     * @brief Replaces the extreme if a candidate beats it.
+     * @param coordinate Coordinate of the candidate.
+     * @param zip Zip code of the candidate.
+     * @param place Place name of the candidate.
+     * @param smaller True if the smaller coordinate wins, false if the larger one does.
+     * @param byPlaceName True to break coordinate ties by place name, false by zip code.
+     *
+     * Ties are broken by the sort key, as if the records had been sorted first and the
+     * first one kept, so the result does not depend on the order records arrive in.
+     */
+    void offer(double coordinate, int zip, string_view place, bool smaller, bool byPlaceName);
+};
+
+/**
+ * @struct StateExtremes
+ * @brief Fixed-size accumulator of the four extreme locations of one state.
+ */
+struct StateExtremes {
+    LocationExtreme east;   ///< Least longitude.
+    LocationExtreme west;   ///< Greatest longitude.
+    LocationExtreme north;  ///< Greatest latitude.
+    LocationExtreme south;  ///< Least latitude.
+
+    /**
+     * @brief Folds one record into the extremes.
+     * @param record The record.
+     * @param byPlaceName True to break ties by place name, false by zip code.
+     */
+    void add(const ZipCodeRecord& record, bool byPlaceName);
+
+    /**
+     * @brief Folds the extremes of another part of the input into these.
+     * @param other Extremes of the same state from another part.
+     * @param byPlaceName True to break ties by place name, false by zip code.
+     */
+    void merge(const StateExtremes& other, bool byPlaceName);
+};
+
 /**
  * @class Buffer
  * @brief A class to handle reading, processing, and validating zip code data.
  */
 class Buffer {
+private:
+    StringInterner strings; ///< One copy of every place, state and county name read
+
 public:
     /**
      * @brief Reads a length-indicated file and stores zip code records.
@@ -46,7 +104,7 @@ public:
      * @return True if the file is read successfully, false otherwise.
      *
      * This function reads a length-indicated file containing zip code data, extracts fields, checks for missing values,
-     * and stores valid records into a vector.
+     * and stores valid records into a vector. Names are interned, so only distinct strings are allocated.
      */
     bool readLengthIndicatedFile(const string& filename, vector<ZipCodeRecord>& records);
 
@@ -55,9 +113,45 @@ public:
      * @param records The vector of zip code records.
      * @param state_map A map to store zip codes categorized by state.
      *
-     * This function groups zip code records by state into a map for easy retrieval.
+     * This function groups zip code records by state into a map for easy retrieval. Each state's vector is
+     * sized once, so grouping allocates per state rather than per record.
      */
     void processRecords(const vector<ZipCodeRecord>& records, map<string, vector<ZipCodeRecord>>& state_map);
+
+    /**
+     * @brief Finds the extreme locations of each state in one pass over a length-indicated file.
+     * @param filename The name of the length-indicated file to read.
+     * @param byPlaceName True to break coordinate ties by place name, false by zip code.
+     * @param extremes A map to store the extremes of each state.
+     * @param threadCount Number of threads, or 0 to use every hardware thread.
+     * @return True if the file is read successfully, false otherwise.
+     *
+     * No records are kept: the file is split into one line-aligned range per thread, each thread folds its
+     * records into its own per-state accumulators, and the accumulators are merged at the end. Time is linear
+     * in the file size and memory is proportional to the number of states. Names are not interned.
+     */
+    bool readStateExtremes(const string& filename, bool byPlaceName, map<string, StateExtremes>& extremes,
+                           unsigned threadCount = 0);
+
+    /**
+     * @brief Computes the convex hull of each state's locations in one pass over a length-indicated file.
+     * @param filename The name of the length-indicated file to read.
+     * @param hulls Output parameter for the hulls; any previous hulls are removed.
+     * @param threadCount Number of threads, or 0 to use every hardware thread.
+     * @return True if the file is read successfully, false otherwise.
+     *
+     * The file is split into line-aligned ranges as in readStateExtremes(). Each thread runs the monotone
+     * chain on its range's locations of every state, and the partial hulls of a state are merged by running
+     * it again on their vertices, so the final pass only sees a few vertices per range.
+     */
+    bool readStateHulls(const string& filename, StateHulls& hulls, unsigned threadCount = 0);
+
+    /**
+     * @brief Frees every interned name at once.
+     *
+     * Records read by this Buffer must not be used afterwards.
+     */
+    void release() { strings.release(); }
 };
 
 #endif // BUFFER_H
@@ -5,16 +5,19 @@
 
 #include "CSVConverter.h"
 #include <iomanip>
+#include <charconv>
+#include "CSVScanner.h"
+#include "MappedFile.h"
 
 void CSVConverter::convertToLengthIndicated(const string& csvFilename, const string& outputFilename) {
-    ifstream inputFile(csvFilename);
+    MappedFile inputFile(csvFilename);
 
     string modifiedOutputFilename = outputFilename;
     if (modifiedOutputFilename.find(".txt") != string::npos) {
         modifiedOutputFilename.replace(modifiedOutputFilename.find(".txt"), 4, ".csv");
     }
 
-    if (!inputFile.is_open()) {
+    if (!inputFile.isOpen()) {
         cerr << "Error: Could not open input file: " << csvFilename << endl;
         return;
     }
@@ -46,15 +49,23 @@ void CSVConverter::convertToLengthIndicated(const string& csvFilename, const str
     HeaderBuffer::writeHeader(modifiedOutputFilename, header); // Write the header to the file
 
     // Append records with length-indicated lines
-    ofstream appendFile(modifiedOutputFilename, ios::app);
-    string line;
-    getline(inputFile, line); // Skip CSV column header
+    ofstream appendFile(modifiedOutputFilename, ios::app | ios::binary);
+    CSVBulkReader reader(inputFile.data(), inputFile.size());
+    string_view line;
+    reader.nextRecord(line); // Skip CSV column header
     
     int recordCount = 0;
-    while (getline(inputFile, line)) {
+    char lengthStr[16];
+    while (reader.nextRecord(line)) {
+        // Length prefix is at least two digits
         int length = line.size();
-        string lengthStr = (length < 10) ? "0" + to_string(length) : to_string(length);
-        appendFile << lengthStr << "," << line << '\n';
+        char* end = lengthStr;
+        if (length < 10) *end++ = '0';
+        end = to_chars(end, lengthStr + sizeof(lengthStr) - 1, length).ptr;
+        *end++ = ',';
+        appendFile.write(lengthStr, end - lengthStr);
+        appendFile.write(line.data(), line.size());
+        appendFile.put('\n');
         recordCount++;
     }
 
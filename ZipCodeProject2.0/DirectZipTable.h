@@ -0,0 +1,247 @@
+/**
+ * @file DirectZipTable.h
+ * @brief Definition of the DirectZipTable class, a direct-address table over the 5-digit Zip Code space
+ *
+ * Every Zip Code from 0 to 99999 has its own slot holding a value (a file
+ * offset or an RBN) or NO_ENTRY, so a lookup is one array read with no key
+ * comparisons. The table is stored as a flat file that is memory-mapped for
+ * lookups; the first update copies it into memory, and save() writes back
+ * only the slots that changed.
+ */
+
+#ifndef DIRECT_ZIP_TABLE_H
+#define DIRECT_ZIP_TABLE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include "MappedFile.h"
+#include "LittleEndian.h"
+
+/**
+ * @class DirectZipTable
+ * @brief Flat Zip Code → value table with one 64-bit slot per possible Zip Code
+ */
+class DirectZipTable {
+public:
+    static constexpr uint32_t SLOT_COUNT = 100000;  ///< One slot per 5-digit Zip Code
+    static constexpr int64_t NO_ENTRY = -1;         ///< Value of slots with no Zip Code
+
+private:
+    static constexpr char MAGIC[8] = {'Z', 'I', 'P', 'D', 'I', 'R', 'C', 'T'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 32;       ///< magic, version, slot count, entry size, entry count
+    static constexpr size_t ENTRY_SIZE = 8;         ///< int64 little-endian per slot
+
+    MappedFile mapped;                  ///< Table file, read in place until the first update
+    std::vector<int64_t> values;        ///< In-memory slots (empty while reading from the mapping)
+    std::vector<uint32_t> dirtySlots;   ///< Slots changed since the last save
+    uint64_t entryCount;                ///< Number of slots not set to NO_ENTRY
+    bool rewrite;                       ///< Whether save() must write the whole file
+
+    /**
+     * @brief Copy the mapped slots into memory so they can be updated
+     */
+    void materialize() {
+        if (!values.empty()) {
+            return;
+        }
+        values.assign(SLOT_COUNT, NO_ENTRY);
+        if (mapped.isOpen()) {
+            const char* slots = mapped.data() + HEADER_SIZE;
+            for (uint32_t slot = 0; slot < SLOT_COUNT; slot++) {
+                values[slot] = static_cast<int64_t>(getLE(slots + slot * ENTRY_SIZE, 8));
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Constructor (empty table, every slot NO_ENTRY)
+     */
+    DirectZipTable() : entryCount(0), rewrite(false) {}
+
+    DirectZipTable(const DirectZipTable&) = delete;
+    DirectZipTable& operator=(const DirectZipTable&) = delete;
+
+    /**
+     * @brief Get the slot of a Zip Code
+     * @param zipCode Zip Code of 1 to 5 digits ("501" and "00501" share a slot)
+     * @param slot Output parameter for the slot
+     * @return true if the Zip Code has a slot, false if it is not numeric or too long
+     */
+    static bool slotFor(std::string_view zipCode, uint32_t& slot) {
+        if (zipCode.empty() || zipCode.size() > 5) {
+            return false;
+        }
+        uint32_t value = 0;
+        for (char c : zipCode) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            value = value * 10 + (c - '0');
+        }
+        slot = value;
+        return true;
+    }
+
+    /**
+     * @brief Check if a file is a direct-address table
+     * @param data Start of the file contents
+     * @param size Size of the file contents
+     * @return true if the file starts with the table's magic
+     */
+    static bool isTableFile(const char* data, size_t size) {
+        return size >= sizeof(MAGIC) && std::string_view(data, sizeof(MAGIC)) == std::string_view(MAGIC, sizeof(MAGIC));
+    }
+
+    /**
+     * @brief Start a new table with every slot set to NO_ENTRY
+     */
+    void reset() {
+        mapped.close();
+        values.assign(SLOT_COUNT, NO_ENTRY);
+        dirtySlots.clear();
+        entryCount = 0;
+        rewrite = true;
+    }
+
+    /**
+     * @brief Release the table (isOpen() becomes false)
+     */
+    void close() {
+        mapped.close();
+        values.clear();
+        dirtySlots.clear();
+        entryCount = 0;
+        rewrite = false;
+    }
+
+    /**
+     * @brief Map a table file for lookups
+     * @param fileName Name of the table file
+     * @return true if successful, false if the file is missing or not a valid table
+     */
+    bool load(const std::string& fileName) {
+        close();
+        if (!mapped.open(fileName)) {
+            return false;
+        }
+        const char* data = mapped.data();
+        if (mapped.size() != HEADER_SIZE + SLOT_COUNT * ENTRY_SIZE || !isTableFile(data, mapped.size()) ||
+            getLE(data + 8, 4) != VERSION || getLE(data + 12, 4) != SLOT_COUNT ||
+            getLE(data + 16, 4) != ENTRY_SIZE) {
+            mapped.close();
+            return false;
+        }
+        entryCount = getLE(data + 20, 8);
+        return true;
+    }
+
+    /**
+     * @brief Write changed slots (or the whole table, if new) to the table file
+     * @param fileName Name of the table file
+     * @return true if successful, false otherwise
+     */
+    bool save(const std::string& fileName) {
+        char entry[ENTRY_SIZE];
+
+        if (rewrite) {
+            materialize();
+            std::string data(HEADER_SIZE + SLOT_COUNT * ENTRY_SIZE, '\0');
+            data.replace(0, sizeof(MAGIC), MAGIC, sizeof(MAGIC));
+            putLE(&data[8], VERSION, 4);
+            putLE(&data[12], SLOT_COUNT, 4);
+            putLE(&data[16], ENTRY_SIZE, 4);
+            putLE(&data[20], entryCount, 8);
+            for (uint32_t slot = 0; slot < SLOT_COUNT; slot++) {
+                putLE(&data[HEADER_SIZE + slot * ENTRY_SIZE], static_cast<uint64_t>(values[slot]), 8);
+            }
+
+            std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+            if (!file.is_open() || !file.write(data.data(), data.size())) {
+                return false;
+            }
+        } else if (!dirtySlots.empty()) {
+            // Patch only the changed slots in place
+            std::ofstream file(fileName, std::ios::binary | std::ios::in | std::ios::out);
+            if (!file.is_open()) {
+                return false;
+            }
+            for (uint32_t slot : dirtySlots) {
+                putLE(entry, static_cast<uint64_t>(values[slot]), 8);
+                file.seekp(HEADER_SIZE + slot * ENTRY_SIZE);
+                file.write(entry, ENTRY_SIZE);
+            }
+            putLE(entry, entryCount, 8);
+            file.seekp(20);
+            file.write(entry, 8);
+            if (!file) {
+                return false;
+            }
+        }
+
+        dirtySlots.clear();
+        rewrite = false;
+        return true;
+    }
+
+    /**
+     * @brief Get the value of a slot
+     * @param slot The slot (from slotFor)
+     * @return The value, or NO_ENTRY
+     */
+    int64_t get(uint32_t slot) const {
+        if (slot >= SLOT_COUNT) {
+            return NO_ENTRY;
+        }
+        if (!values.empty()) {
+            return values[slot];
+        }
+        if (mapped.isOpen()) {
+            return static_cast<int64_t>(getLE(mapped.data() + HEADER_SIZE + slot * ENTRY_SIZE, 8));
+        }
+        return NO_ENTRY;
+    }
+
+    /**
+     * @brief Set the value of a slot
+     * @param slot The slot (from slotFor)
+     * @param value The value, or NO_ENTRY to clear the slot
+     */
+    void set(uint32_t slot, int64_t value) {
+        if (slot >= SLOT_COUNT) {
+            return;
+        }
+        materialize();
+        if (values[slot] != value) {
+            entryCount += (value != NO_ENTRY) - (values[slot] != NO_ENTRY);
+            values[slot] = value;
+            if (!rewrite) {
+                dirtySlots.push_back(slot);
+            }
+        }
+    }
+
+    /**
+     * @brief Get the number of Zip Codes in the table
+     * @return The number of slots not set to NO_ENTRY
+     */
+    uint64_t size() const { return entryCount; }
+
+    /**
+     * @brief Check if the table is available for lookups
+     * @return true after load() or reset()
+     */
+    bool isOpen() const { return !values.empty() || mapped.isOpen(); }
+
+    /**
+     * @brief Check if the table has unsaved changes
+     * @return true if save() is needed
+     */
+    bool isDirty() const { return rewrite || !dirtySlots.empty(); }
+};
+
+#endif // DIRECT_ZIP_TABLE_H
@@ -0,0 +1,293 @@
+/**
+ * @file QueryServer.h
+ * @brief Definition of the QueryServer class, a line-based request loop for long-lived lookup processes
+ *
+ * A search program that answers one query per process spends nearly all of
+ * its time starting up and loading its index. QueryServer keeps the process
+ * (and whatever the handler holds open) alive and answers newline-delimited
+ * queries, one response line per query, in order. Queries are read in bulk
+ * and their responses are written together, so a client can pipeline many
+ * queries without waiting for each answer.
+ */
+
+#ifndef QUERY_SERVER_H
+#define QUERY_SERVER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <csignal>
+#include <cerrno>
+#define QUERY_SERVER_USE_SOCKETS 1
+#endif
+
+/**
+ * @class QueryServer
+ * @brief Answers newline-delimited queries over a stream pair or a Unix domain socket
+ */
+class QueryServer {
+public:
+    /**
+     * @brief Query handler: writes the response (without a trailing newline) for one query
+     */
+    using Handler = std::function<void(std::string_view query, std::string& response)>;
+
+private:
+    static constexpr size_t READ_SIZE = 64 * 1024;  ///< Bytes requested per socket read
+
+    Handler handler;      ///< Produces the response to each query
+    uint64_t queries;     ///< Number of queries answered
+
+    /**
+     * @brief Answer one query and append its response line
+     * @param line The query line (a trailing carriage return is ignored)
+     * @param out Buffer the response line is appended to
+     */
+    void answer(std::string_view line, std::string& out) {
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        std::string response;
+        handler(line, response);
+        out += response;
+        out += '\n';
+        queries++;
+    }
+
+#ifdef QUERY_SERVER_USE_SOCKETS
+    static constexpr size_t MAX_UNSENT = 1024 * 1024;  ///< Unsent answers at which a client's queries stop being read
+
+    /**
+     * @brief One connected client of the socket server
+     */
+    struct Client {
+        int fd = -1;            ///< Client socket (non-blocking)
+        std::string pending;    ///< Bytes of a query line not yet complete
+        std::string responses;  ///< Answers not yet sent
+        size_t sent = 0;        ///< Bytes of responses already sent
+        bool reading = true;    ///< false once the client has ended its queries
+        bool failed = false;    ///< true once the connection has failed
+    };
+
+    /**
+     * @brief Get the poll events a client is waiting for
+     *
+     * A client that sends queries without reading the answers is not read
+     * from while MAX_UNSENT bytes of answers wait for it, so it cannot make
+     * the server buffer without bound.
+     * @param client The client
+     * @return POLLIN, POLLOUT, both or neither
+     */
+    static short wantedEvents(const Client& client) {
+        size_t unsent = client.responses.size() - client.sent;
+        return static_cast<short>((client.reading && unsent < MAX_UNSENT ? POLLIN : 0) | (unsent > 0 ? POLLOUT : 0));
+    }
+
+    /**
+     * @brief Send as much of a client's answers as its socket accepts
+     * @param client The client
+     */
+    static void writeTo(Client& client) {
+        ssize_t n = ::write(client.fd, client.responses.data() + client.sent, client.responses.size() - client.sent);
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            client.failed = true;
+            return;
+        }
+        client.sent += n > 0 ? static_cast<size_t>(n) : 0;
+        if (client.sent == client.responses.size()) {
+            client.responses.clear();
+            client.sent = 0;
+        }
+    }
+
+    /**
+     * @brief Read a client's queries and answer every complete line received so far
+     * @param client The client
+     * @param buffer Read buffer of READ_SIZE bytes
+     */
+    void readFrom(Client& client, char* buffer) {
+        ssize_t n = ::read(client.fd, buffer, READ_SIZE);
+        if (n < 0) {
+            client.failed = errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR;
+            return;
+        }
+        if (n == 0) {
+            // End of queries: answer a last line without a newline
+            client.reading = false;
+            if (!client.pending.empty()) {
+                answer(client.pending, client.responses);
+            }
+            return;
+        }
+        client.pending.append(buffer, static_cast<size_t>(n));
+
+        size_t start = 0;
+        size_t newline;
+        while ((newline = client.pending.find('\n', start)) != std::string::npos) {
+            answer(std::string_view(client.pending).substr(start, newline - start), client.responses);
+            start = newline + 1;
+        }
+        client.pending.erase(0, start);
+    }
+#endif
+
+public:
+    /**
+     * @brief Constructor
+     * @param queryHandler Produces the response to each query
+     */
+    explicit QueryServer(Handler queryHandler) : handler(std::move(queryHandler)), queries(0) {}
+
+    /**
+     * @brief Answer queries from a stream until it ends (e.g. stdin/stdout)
+     *
+     * Output is flushed only when no more input is already buffered, so
+     * pipelined queries are answered in one write. Call
+     * std::ios::sync_with_stdio(false) first when serving std::cin, or every
+     * line is flushed on its own.
+     * @param in Query stream
+     * @param out Response stream
+     */
+    void serveStream(std::istream& in, std::ostream& out) {
+        std::string line;
+        std::string responses;
+        while (std::getline(in, line)) {
+            answer(line, responses);
+            if (in.rdbuf()->in_avail() <= 0) {
+                out.write(responses.data(), responses.size());
+                out.flush();
+                responses.clear();
+            }
+        }
+        out.write(responses.data(), responses.size());
+        out.flush();
+    }
+
+    /**
+     * @brief Listen on a Unix domain socket and answer any number of clients at once
+     *
+     * Every client has its own query and answer buffers, and all of them
+     * are polled together with the listening socket, so an idle or slow
+     * client (one holding a connection open, or not reading its answers)
+     * never holds up the others. Only returns if the socket cannot be set
+     * up or fails. Any file at the socket path is replaced.
+     * @param path Socket path
+     * @return false if the socket could not be created (or sockets are unavailable)
+     */
+    bool serveSocket(const std::string& path) {
+#ifdef QUERY_SERVER_USE_SOCKETS
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+            std::cerr << "Error: Invalid socket path " << path << std::endl;
+            return false;
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0) {
+            std::cerr << "Error: Could not create socket" << std::endl;
+            return false;
+        }
+        ::unlink(path.c_str());
+        if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+            ::listen(listener, 16) < 0) {
+            std::cerr << "Error: Could not listen on " << path << std::endl;
+            ::close(listener);
+            return false;
+        }
+
+        // A client that disconnects mid-response must not end the server
+        std::signal(SIGPIPE, SIG_IGN);
+        ::fcntl(listener, F_SETFL, ::fcntl(listener, F_GETFL, 0) | O_NONBLOCK);
+
+        // The listener and every client are polled together, so no client waits on another
+        std::vector<Client> clients;
+        std::vector<pollfd> events;
+        std::vector<char> buffer(READ_SIZE);
+        for (;;) {
+            events.assign(1, pollfd{listener, POLLIN, 0});
+            for (const Client& client : clients) {
+                events.push_back({client.fd, wantedEvents(client), 0});
+            }
+            if (::poll(events.data(), events.size(), -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::cerr << "Error: Could not poll connections on " << path << std::endl;
+                break;
+            }
+
+            // Each ready client gets one read and one write per round
+            for (size_t i = 0; i < clients.size(); i++) {
+                Client& client = clients[i];
+                short revents = events[i + 1].revents;
+                if ((revents & (POLLERR | POLLNVAL)) || ((revents & POLLHUP) && !(revents & (POLLIN | POLLOUT)))) {
+                    client.failed = true;
+                    continue;
+                }
+                if (revents & POLLOUT) {
+                    writeTo(client);
+                }
+                if (!client.failed && (events[i + 1].events & POLLIN) && (revents & (POLLIN | POLLHUP))) {
+                    readFrom(client, buffer.data());
+                }
+            }
+
+            // Drop clients that failed or have ended their queries and received every answer
+            clients.erase(std::remove_if(clients.begin(), clients.end(),
+                                         [](const Client& client) {
+                                             bool done = client.failed ||
+                                                         (!client.reading && client.sent == client.responses.size());
+                                             if (done) {
+                                                 ::close(client.fd);
+                                             }
+                                             return done;
+                                         }),
+                          clients.end());
+
+            if (events[0].revents & POLLIN) {
+                int fd;
+                while ((fd = ::accept(listener, nullptr, nullptr)) >= 0) {
+                    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+                    clients.emplace_back();
+                    clients.back().fd = fd;
+                }
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED) {
+                    std::cerr << "Error: Could not accept connection on " << path << std::endl;
+                    break;
+                }
+            }
+        }
+
+        for (const Client& client : clients) {
+            ::close(client.fd);
+        }
+        ::close(listener);
+        return false;
+#else
+        std::cerr << "Error: Unix domain sockets are not available on this platform (" << path << ")" << std::endl;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Get the number of queries answered
+     * @return The query count
+     */
+    uint64_t queryCount() const { return queries; }
+};
+
+#endif // QUERY_SERVER_H
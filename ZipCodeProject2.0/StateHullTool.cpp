@@ -0,0 +1,122 @@
+/**
+ * @file StateHullTool.cpp
+ * @brief Builds and queries the convex hull file of each state's Zip Code locations.
+ *
+ * "build" reads a length-indicated file once and saves the hull of every state next to it. "extreme" reports
+ * the Zip Code of a state furthest in any compass bearing, and "farthest" the two Zip Codes of a state that are
+ * furthest apart; both read only the hull file.
+ */
+
+#include "Buffer.h"
+#include "StateHulls.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Prints one location of a hull.
+ */
+static void printVertex(const StateHulls::Vertex& vertex) {
+    cout << setw(5) << setfill('0') << vertex.zipCode << setfill(' ') << " (" << vertex.latitude << ", "
+         << StateHulls::wrapLongitude(vertex.longitude) << ")";
+}
+
+/**
+ * @brief Prints the farthest pair of one state.
+ */
+static void printFarthest(const string& state, const StateHulls::Hull& hull) {
+    cout << state << ": ";
+    if (hull.vertices.size() < 2) {
+        cout << "single location\n";
+        return;
+    }
+    printVertex(hull.vertices[hull.farthestA]);
+    cout << " - ";
+    printVertex(hull.vertices[hull.farthestB]);
+    cout << " " << fixed << setprecision(1) << hull.farthestKm << " km\n" << defaultfloat << setprecision(6);
+}
+
+/**
+ * @brief Main function for building and querying state hulls.
+ * @param argc Number of command-line arguments.
+ * @param argv Command-line argument list: a command and its arguments (see the usage line).
+ * @return 0 on success, 1 on failure.
+ */
+int main(int argc, char* argv[]) {
+    string command = argc > 1 ? argv[1] : "";
+    if ((command != "build" || argc < 3) && (command != "extreme" || argc != 5) &&
+        (command != "farthest" || argc < 3 || argc > 4)) {
+        cerr << " Usage: " << argv[0] << " build <datafile> [hullfile] [-j<threads>]\n"
+             << "        " << argv[0] << " extreme <hullfile> <state> <bearing_degrees>\n"
+             << "        " << argv[0] << " farthest <hullfile> [state]\n";
+        return 1;
+    }
+
+    StateHulls hulls;
+    if (command == "build") {
+        string dataFilename = argv[2];
+        string hullFilename = dataFilename + ".hull";
+        unsigned threads = 0; // 0 uses every hardware thread
+        for (int i = 3; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg.size() > 2 && arg.compare(0, 2, "-j") == 0) {
+                threads = static_cast<unsigned>(max(0, atoi(arg.c_str() + 2)));
+            } else {
+                hullFilename = arg;
+            }
+        }
+
+        Buffer buffer;
+        if (!buffer.readStateHulls(dataFilename, hulls, threads)) {
+            return 1;
+        }
+        if (!hulls.save(hullFilename)) {
+            cerr << " Error: Could not write " << hullFilename << endl;
+            return 1;
+        }
+        size_t vertices = 0;
+        for (const auto& entry : hulls.getHulls()) {
+            vertices += entry.second.vertices.size();
+        }
+        cout << " Hulls of " << hulls.getHulls().size() << " states (" << vertices << " vertices) saved as "
+             << hullFilename << endl;
+        return 0;
+    }
+
+    string hullFilename = argv[2];
+    if (!hulls.load(hullFilename)) {
+        cerr << " Error: Could not read the hull file " << hullFilename << endl;
+        return 1;
+    }
+
+    if (command == "extreme") {
+        string state = argv[3];
+        double bearing = atof(argv[4]);
+        StateHulls::Vertex vertex;
+        if (!hulls.extreme(state, bearing, vertex)) {
+            cerr << " Error: No locations for state " << state << endl;
+            return 1;
+        }
+        cout << state << " bearing " << bearing << ": ";
+        printVertex(vertex);
+        cout << "\n";
+        return 0;
+    }
+
+    if (argc == 4) {
+        const StateHulls::Hull* hull = hulls.find(argv[3]);
+        if (!hull) {
+            cerr << " Error: No locations for state " << argv[3] << endl;
+            return 1;
+        }
+        printFarthest(argv[3], *hull);
+    } else {
+        for (const auto& entry : hulls.getHulls()) {
+            printFarthest(entry.first, entry.second);
+        }
+    }
+    return 0;
+}
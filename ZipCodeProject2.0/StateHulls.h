@@ -0,0 +1,325 @@
+/**
+ * @file StateHulls.h
+ * @brief Definition of the StateHulls class, the convex hull of each state's Zip Code locations
+ *
+ * The location furthest in any compass direction is always a vertex of the
+ * convex hull, so keeping only the hull (a few dozen points per state)
+ * answers "furthest north-east" or any other bearing without the records.
+ * Hulls are computed on (longitude, latitude); scaling longitude does not
+ * change which points are on a hull, so the same hull serves the local
+ * projection a query uses, where a degree of longitude is cos(latitude) as
+ * long as a degree of latitude. Queries binary-search the hull's edge
+ * angles, so they take O(log h) for a hull of h vertices. Every location
+ * in the data lies west of Greenwich, so positive longitudes (Wake Island
+ * and the Pacific territories) are unwrapped to below -180 to keep a state
+ * that straddles the 180° meridian in one piece.
+ *
+ * The farthest pair of each state is taken from its hull vertices when the
+ * hull is added, by comparing great-circle distances of all vertex pairs.
+ * The hull is planar, so this is exact only while a state is small next to
+ * the globe; for the Zip Code data it matches a scan of every record pair.
+ */
+
+#ifndef STATE_HULLS_H
+#define STATE_HULLS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "LittleEndian.h"
+#include "ZipDistances.h"
+
+/**
+ * @class StateHulls
+ * @brief Convex hulls of the locations of each state, persisted to a hull file
+ */
+class StateHulls {
+public:
+    /**
+     * @brief One location, a hull vertex once the hull is built
+     */
+    struct Vertex {
+        double latitude;   ///< Latitude in degrees
+        double longitude;  ///< Longitude in degrees, unwrapped by unwrapLongitude()
+        int zipCode;       ///< Zip Code
+    };
+
+    /**
+     * @brief Hull and farthest pair of one state
+     */
+    struct Hull {
+        std::vector<Vertex> vertices;     ///< Vertices in counter-clockwise order, from the westernmost
+        std::vector<double> edgeAngles;   ///< Projected angle of each edge, increasing (not stored)
+        double scale = 1.0;               ///< Projected length of a degree of longitude (not stored)
+        uint32_t farthestA = 0;           ///< Index of one end of the farthest pair
+        uint32_t farthestB = 0;           ///< Index of the other end of the farthest pair
+        double farthestKm = 0.0;          ///< Great-circle distance of the farthest pair
+    };
+
+private:
+    static constexpr char MAGIC[8] = {'Z', 'I', 'P', 'H', 'U', 'L', 'L', 'S'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t STATE_NAME_SIZE = 8;   ///< State names are zero padded to this size
+    static constexpr size_t VERTEX_SIZE = 24;      ///< latitude, longitude, zip, 4 pad bytes
+
+    std::map<std::string, Hull, std::less<>> hulls;  ///< Hull of each state
+
+    /**
+     * @brief Cross product of (b - a) and (c - a) in (longitude, latitude)
+     * @return Positive if a, b, c turn counter-clockwise
+     */
+    static double cross(const Vertex& a, const Vertex& b, const Vertex& c) {
+        return (b.longitude - a.longitude) * (c.latitude - a.latitude) -
+               (b.latitude - a.latitude) * (c.longitude - a.longitude);
+    }
+
+    /**
+     * @brief Compute the projection and edge angles a hull is searched with
+     *
+     * Longitude is scaled by the cosine of the hull's middle latitude. Edge
+     * angles of a counter-clockwise hull increase around it; 2π is added
+     * where atan2 wraps, so the array is sorted for binary search.
+     */
+    static void prepare(Hull& hull) {
+        const double radians = M_PI / 180.0;
+        double south = 90, north = -90;
+        for (const Vertex& vertex : hull.vertices) {
+            south = std::min(south, vertex.latitude);
+            north = std::max(north, vertex.latitude);
+        }
+        hull.scale = hull.vertices.empty() ? 1.0 : std::cos((south + north) / 2 * radians);
+
+        size_t count = hull.vertices.size();
+        hull.edgeAngles.clear();
+        for (size_t i = 0; count > 1 && i < count; i++) {
+            const Vertex& from = hull.vertices[i];
+            const Vertex& to = hull.vertices[(i + 1) % count];
+            double angle = std::atan2(to.latitude - from.latitude, (to.longitude - from.longitude) * hull.scale);
+            while (!hull.edgeAngles.empty() && angle < hull.edgeAngles.back()) {
+                angle += 2 * M_PI;
+            }
+            hull.edgeAngles.push_back(angle);
+        }
+    }
+
+public:
+    /**
+     * @brief Map a longitude onto the continuous range used by the hulls
+     * @param longitude Longitude in degrees, from -180 to 180
+     * @return The longitude, less 360 if it is east of Greenwich
+     */
+    static double unwrapLongitude(double longitude) { return longitude > 0 ? longitude - 360 : longitude; }
+
+    /**
+     * @brief Map an unwrapped longitude back to the range -180 to 180
+     */
+    static double wrapLongitude(double longitude) { return longitude < -180 ? longitude + 360 : longitude; }
+
+    /**
+     * @brief Great-circle distance between two locations
+     * @return The distance in km
+     */
+    static double distanceKm(const Vertex& a, const Vertex& b) {
+        return ZipDistances::distanceKm(a.latitude, a.longitude, b.latitude, b.longitude);
+    }
+
+    /**
+     * @brief Replace a set of locations with their convex hull (Andrew's monotone chain)
+     *
+     * Collinear points are dropped, and of several records at one location
+     * only the smallest Zip Code is kept. The result is counter-clockwise,
+     * starting from the westernmost (then southernmost) vertex. Because the
+     * hull of a union is the hull of the parts' hulls, parts of the input can
+     * be reduced independently and their hulls reduced again.
+     * @param points The locations; replaced by the hull vertices
+     */
+    static void reduceToHull(std::vector<Vertex>& points) {
+        std::sort(points.begin(), points.end(), [](const Vertex& a, const Vertex& b) {
+            if (a.longitude != b.longitude) return a.longitude < b.longitude;
+            if (a.latitude != b.latitude) return a.latitude < b.latitude;
+            return a.zipCode < b.zipCode;
+        });
+        points.erase(std::unique(points.begin(), points.end(),
+                                 [](const Vertex& a, const Vertex& b) {
+                                     return a.longitude == b.longitude && a.latitude == b.latitude;
+                                 }),
+                     points.end());
+        if (points.size() < 3) {
+            return;
+        }
+
+        std::vector<Vertex> hull(2 * points.size());
+        size_t k = 0;
+        for (size_t i = 0; i < points.size(); i++) {  // Lower chain
+            while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) {
+                k--;
+            }
+            hull[k++] = points[i];
+        }
+        for (size_t i = points.size() - 1, lower = k + 1; i-- > 0;) {  // Upper chain
+            while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) {
+                k--;
+            }
+            hull[k++] = points[i];
+        }
+        hull.resize(k - 1);  // The last point is the first one again
+        points.swap(hull);
+    }
+
+    /**
+     * @brief Set the hull of a state and find its farthest pair
+     * @param state State abbreviation (at most 8 characters)
+     * @param vertices Hull vertices, as left by reduceToHull()
+     */
+    void setHull(std::string_view state, std::vector<Vertex> vertices) {
+        Hull& hull = hulls[std::string(state.substr(0, STATE_NAME_SIZE))];
+        hull = Hull();
+        hull.vertices = std::move(vertices);
+        for (uint32_t a = 0; a < hull.vertices.size(); a++) {
+            for (uint32_t b = a + 1; b < hull.vertices.size(); b++) {
+                double km = distanceKm(hull.vertices[a], hull.vertices[b]);
+                if (km > hull.farthestKm) {
+                    hull.farthestKm = km;
+                    hull.farthestA = a;
+                    hull.farthestB = b;
+                }
+            }
+        }
+        prepare(hull);
+    }
+
+    /**
+     * @brief Find a state's location furthest in a compass direction
+     *
+     * The direction is measured in the state's local projection, so a
+     * bearing of 45 means as far north-east as a map of the state shows.
+     * @param state State abbreviation
+     * @param bearingDegrees Compass bearing: 0 north, 90 east, 180 south, 270 west
+     * @param result Output parameter for the location
+     * @return true if the state has a hull, false otherwise
+     */
+    bool extreme(std::string_view state, double bearingDegrees, Vertex& result) const {
+        auto it = hulls.find(state);
+        if (it == hulls.end() || it->second.vertices.empty()) {
+            return false;
+        }
+        const Hull& hull = it->second;
+        if (hull.edgeAngles.empty()) {
+            result = hull.vertices[0];
+            return true;
+        }
+
+        // The furthest vertex is where the edge direction passes the query direction turned 90° left
+        double target = (90.0 - bearingDegrees) * M_PI / 180.0 + M_PI / 2;
+        double first = hull.edgeAngles.front();
+        target = first + std::fmod(std::fmod(target - first, 2 * M_PI) + 2 * M_PI, 2 * M_PI);
+        size_t edge = std::upper_bound(hull.edgeAngles.begin(), hull.edgeAngles.end(), target) -
+                      hull.edgeAngles.begin();
+        result = hull.vertices[edge % hull.vertices.size()];
+        return true;
+    }
+
+    /**
+     * @brief Get a state's hull
+     * @param state State abbreviation
+     * @return The hull, or nullptr if the state has none
+     */
+    const Hull* find(std::string_view state) const {
+        auto it = hulls.find(state);
+        return it == hulls.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * @brief Get every state's hull
+     * @return The hulls, in state order
+     */
+    const std::map<std::string, Hull, std::less<>>& getHulls() const { return hulls; }
+
+    /**
+     * @brief Remove all hulls
+     */
+    void clear() { hulls.clear(); }
+
+    /**
+     * @brief Write the hulls to a hull file
+     * @param fileName Name of the hull file
+     * @return true if successful, false otherwise
+     */
+    bool save(const std::string& fileName) const {
+        std::string data(MAGIC, sizeof(MAGIC));
+        appendLE(data, VERSION, 4);
+        appendLE(data, hulls.size(), 4);
+        for (const auto& entry : hulls) {
+            const Hull& hull = entry.second;
+            std::string name = entry.first;
+            name.resize(STATE_NAME_SIZE, '\0');
+            data += name;
+            appendLE(data, hull.vertices.size(), 4);
+            appendLE(data, hull.farthestA, 4);
+            appendLE(data, hull.farthestB, 4);
+            appendLE(data, 0, 4);
+            appendDoubleLE(data, hull.farthestKm);
+            for (const Vertex& vertex : hull.vertices) {
+                appendDoubleLE(data, vertex.latitude);
+                appendDoubleLE(data, vertex.longitude);
+                appendLE(data, static_cast<uint32_t>(vertex.zipCode), 4);
+                appendLE(data, 0, 4);
+            }
+        }
+
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        return file.is_open() && file.write(data.data(), data.size());
+    }
+
+    /**
+     * @brief Read the hulls from a hull file
+     * @param fileName Name of the hull file
+     * @return true if successful, false if the file is missing or not a valid hull file
+     */
+    bool load(const std::string& fileName) {
+        clear();
+        std::ifstream file(fileName, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        const size_t HEADER_SIZE = 16, STATE_SIZE = STATE_NAME_SIZE + 24;
+        if (data.size() < HEADER_SIZE || data.compare(0, sizeof(MAGIC), MAGIC, sizeof(MAGIC)) != 0 ||
+            getLE(&data[8], 4) != VERSION) {
+            return false;
+        }
+
+        size_t stateCount = getLE(&data[12], 4);
+        size_t pos = HEADER_SIZE;
+        for (size_t s = 0; s < stateCount; s++) {
+            if (data.size() - pos < STATE_SIZE) {
+                clear();
+                return false;
+            }
+            const char* in = &data[pos];
+            std::string state(in, strnlen(in, STATE_NAME_SIZE));
+            size_t vertexCount = getLE(in + 8, 4);
+            Hull hull;
+            hull.farthestA = getLE(in + 12, 4);
+            hull.farthestB = getLE(in + 16, 4);
+            hull.farthestKm = getDoubleLE(in + 24);
+            pos += STATE_SIZE;
+            if ((data.size() - pos) / VERTEX_SIZE < vertexCount) {
+                clear();
+                return false;
+            }
+            for (size_t v = 0; v < vertexCount; v++, pos += VERTEX_SIZE) {
+                in = &data[pos];
+                hull.vertices.push_back({getDoubleLE(in), getDoubleLE(in + 8), static_cast<int>(getLE(in + 16, 4))});
+            }
+            prepare(hull);
+            hulls[state] = std::move(hull);
+        }
+        return true;
+    }
+};
+
+#endif // STATE_HULLS_H
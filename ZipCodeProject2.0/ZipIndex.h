@@ -2,17 +2,56 @@
 #define ZIPINDEX_H
 
 #include <string>
+#include <string_view>
 #include <map>
+#include <vector>
+#include <cstdint>
+#include "MappedFile.h"
+#include "DirectZipTable.h"
+#include "LearnedIndex.h"
 
 class ZipIndex {
 private:
     std::map<std::string, long> index; // Maps Zip Code → File Offset
 
+    // Binary index file (see saveBinaryIndex), searched in place while mapped
+    MappedFile binaryFile;
+    const char* binaryEntries = nullptr; // Packed (uint32 zip, uint64 offset) entries
+    uint64_t binaryCount = 0;            // Number of packed entries
+    uint64_t binaryChecksum = 0;         // Checksum stored in the file header
+    bool sparse = false;                 // Entries hold the first Zip Code of each page (see buildSparseIndex)
+    bool learned = false;                // learnedModel predicts where each Zip Code is in the entries
+    LearnedIndex learnedModel;
+
+    // Direct-address index file (see saveDirectIndex): one offset slot per 5-digit Zip Code
+    DirectZipTable directTable;
+
+    int verbosity = 1; // 0: errors only, 1: summaries, 2: every indexed Zip Code
+
+    bool findSparsePage(const std::string& zipCode, uint32_t& key, uint64_t& pageStart, uint64_t& pageEnd) const;
+
 public:
+    // Packed binary index entry, as written by saveBinaryIndex and buildBinaryIndex
+    struct Entry {
+        uint32_t zip;
+        uint64_t offset;
+    };
+
+    void setVerbosity(int level);
     void buildIndex(const std::string& filename);
+    bool buildBinaryIndex(const std::string& filename, const std::string& indexFilename, unsigned threadCount = 0,
+                          bool withModel = false);
+    bool buildSparseIndex(const std::string& filename, const std::string& indexFilename, size_t pageSize = 4096);
     void saveIndex(const std::string& indexFilename);
+    bool saveBinaryIndex(const std::string& indexFilename, bool withModel = false);
+    bool saveDirectIndex(const std::string& indexFilename);
     void loadIndex(const std::string& indexFilename);
+    bool verifyIndex() const;
     long findZipCode(const std::string& zipCode) const;
+    long findRecord(const std::string& dataFilename, const std::string& zipCode, std::string& record) const;
+    long findRecord(std::string_view data, const std::string& zipCode, std::string& record) const;
+    bool isSparse() const;
+    size_t size() const;
 };
 
 #endif // ZIPINDEX_H
@@ -2,18 +2,17 @@
  * @file main.cpp
  * @brief Main program for processing zip code data and generating tables.
  *
- * This program reads zip code data from a chosen length-indicated file, sorts it based 
- * on user selection (Zip Code or Place Name), and then organizes the data by state.
- * It outputs the easternmost (least longitude), westernmost, northernmost 
- * (greatest latitude), and southernmost Zip Code in that state, in that order.
+ * This program reads zip code data from a chosen length-indicated file and, in one
+ * streaming pass, finds the easternmost (least longitude), westernmost, northernmost
+ * (greatest latitude), and southernmost Zip Code of each state, in that order. The
+ * user chooses whether Zip Codes or Place Names are reported; locations at the same
+ * coordinate are decided by that choice, as if the records had been sorted by it.
  */
 
 #include <iostream>
 #include <fstream>
-#include <vector>
 #include <map>
 #include <iomanip>
-#include <algorithm>
 #include "Buffer.h"
 #include "HeaderBuffer.h"
 
@@ -24,9 +23,8 @@ using namespace std;
  * @return 0 on successful execution, -1 on error.
  */
 int main() {
-    vector<ZipCodeRecord> records; ///< Holds all zip code records read from file
     Buffer buffer; ///< Instance of Buffer to process records
-    map<string, vector<ZipCodeRecord>> state_map; ///< Map to store zip code records categorized by state
+    map<string, StateExtremes> state_map; ///< Extreme locations of each state
 
     string filename;
     int fileChoice;
@@ -52,11 +50,6 @@ int main() {
     HeaderBuffer::FileHeader header = HeaderBuffer::readHeader(filename); // Read the file header
     HeaderBuffer::printHeader(header); // Print the file header
 
-    if (!buffer.readLengthIndicatedFile(filename, records)) { // Read length-indicated file
-        cerr << "Error: Unable to read length-indicated file: " << filename << endl;
-        return -1;
-    }
-
     char sortChoice;
     while (true) { // Ask user for sorting preference
         cout << "Do you want to sort by Zip Code (Z) or Place Name (P): ";
@@ -69,18 +62,12 @@ int main() {
         cout << "Invalid choice! Please enter 'Z' for Zip Code or 'P' for Place Name.\n";
     }
 
-    if (sortChoice == 'Z') { // Sort data based on user choice
-        sort(records.begin(), records.end(), [](const ZipCodeRecord& a, const ZipCodeRecord& b) {
-            return a.zip_code < b.zip_code;
-        });
-    } else {
-        sort(records.begin(), records.end(), [](const ZipCodeRecord& a, const ZipCodeRecord& b) {
-            return a.place_name < b.place_name;
-        });
+    // Aggregate the file in one pass, keeping only the extremes of each state
+    if (!buffer.readStateExtremes(filename, sortChoice == 'P', state_map)) {
+        cerr << "Error: Unable to read length-indicated file: " << filename << endl;
+        return -1;
     }
 
-    buffer.processRecords(records, state_map);
-
     ofstream outfile_txt("SortedLocations.txt"); ///< Output file for readable table
     ofstream outfile_csv("SortedLocations.csv"); ///< Output file for CSV (^ same information as table)
 
@@ -99,42 +86,18 @@ int main() {
 
     outfile_csv << "State,Easternmost,Westernmost,Northernmost,Southernmost\n";
 
-    // Process each state and determine furthest locations
+    // Write the furthest locations of each state
     for (const auto& entry : state_map) {
         const string& state = entry.first;
-        const vector<ZipCodeRecord>& zipRecords = entry.second;
-
-        string eastPlace, westPlace, northPlace, southPlace;
-        int eastZip, westZip, northZip, southZip;
-        double minLon = numeric_limits<double>::max();
-        double maxLon = numeric_limits<double>::lowest();
-        double maxLat = numeric_limits<double>::lowest();
-        double minLat = numeric_limits<double>::max();
-        
-        // Find furthest zip codes based on coordinates
-        for (const auto& record : zipRecords) {
-            if (record.lon < minLon) {
-                minLon = record.lon;
-                eastZip = record.zip_code;
-                eastPlace = record.place_name;
-            }
-            if (record.lon > maxLon) {
-                maxLon = record.lon;
-                westZip = record.zip_code;
-                westPlace = record.place_name;
-            }
-            if (record.lat > maxLat) {
-                maxLat = record.lat;
-                northZip = record.zip_code;
-                northPlace = record.place_name;
-            }
-            if (record.lat < minLat) {
-                minLat = record.lat;
-                southZip = record.zip_code;
-                southPlace = record.place_name;
-            }
-        }
-        
+        const StateExtremes& extremes = entry.second;
+
+        int eastZip = extremes.east.zip_code, westZip = extremes.west.zip_code;
+        int northZip = extremes.north.zip_code, southZip = extremes.south.zip_code;
+        const string& eastPlace = extremes.east.place_name;
+        const string& westPlace = extremes.west.place_name;
+        const string& northPlace = extremes.north.place_name;
+        const string& southPlace = extremes.south.place_name;
+
         // Write results to output files
         if (sortChoice == 'Z') {
             // Output using zip Codes
@@ -14,10 +14,24 @@
 #include <sstream>
 #include <iomanip>
 #include <set>
+#include <charconv>
 #include "HeaderRecordBuffer.h"
 #include "BlockBuffer.h"
+#include "BlockView.h"
+#include "BlockMap.h"
 #include "RecordBuffer.h"
 #include "ZipCodeRecord.h"
+#include "CompactZipCodeRecord.h"
+#include "CSVScanner.h"
+#include "MappedFile.h"
+#include "DirectZipTable.h"
+#include "LearnedIndex.h"
+#include "ZipKDTree.h"
+#include "ZipGeoIndex.h"
+#include "StateAggregates.h"
+#include "RecordSort.h"
+#include "ZipDistances.h"
+#include <cstdio>
 
 /**
  * @class BSSManager
@@ -28,7 +42,489 @@ private:
     std::string dataFileName;        ///< Name of the data file
     std::string indexFileName;       ///< Name of the index file
     HeaderRecordBuffer header;       ///< Header record buffer
-    std::map<std::string, int> index; ///< Index mapping highest keys to RBNs
+    std::map<std::string, int> index; ///< Index mapping highest keys (every key, in Hilbert layout) to RBNs
+    size_t indexLogEntries;          ///< Lines appended to the index file since it was last rewritten
+    bool headerLoaded;               ///< Whether header reflects the data file
+    BlockMap blockMap;               ///< Extent map, used when blocks are compressed
+    RecordDictionary dictionary;     ///< String dictionary, used by dictionary-encoded records
+    DirectZipTable directIndex;      ///< Zip Code → RBN table, used in direct index mode
+    LearnedIndex learnedIndex;       ///< Model of the index positions, used in learned index mode
+    std::vector<uint64_t> learnedKeys; ///< Order keys of the index's highest keys, in index order
+    std::vector<int> learnedRBNs;    ///< RBNs of the index entries, in index order
+    ZipKDTree spatialIndex;          ///< Latitude/longitude k-d tree, built on the first nearest query
+    ZipGeoIndex geoIndex;            ///< Z-order index, built on the first box or radius query
+    StateAggregates aggregates;      ///< Per-state counts, centroids and extremes, kept with the data file
+    std::ifstream searchFile;        ///< Data file kept open between searches
+    bool verbose;                    ///< Whether search and insert report to standard output
+
+    /**
+     * @brief Read the header record from the data file if not yet loaded
+     * @return true if the header is available, false otherwise
+     */
+    bool readHeader() {
+        if (headerLoaded) {
+            return true;
+        }
+        
+        std::ifstream file(dataFileName, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        
+        header.read(file);
+        file.close();
+        headerLoaded = header.getHeaderRecordSize() > 0;
+
+        // Earlier versions laid blocks out differently; reading them as the current layout finds nothing
+        if (headerLoaded && header.getVersion() != HeaderRecordBuffer::CURRENT_VERSION) {
+            std::cerr << "Error: " << dataFileName << " is a version " << header.getVersion()
+                      << " file, but this program reads version " << HeaderRecordBuffer::CURRENT_VERSION
+                      << "; recreate it from the CSV file with the create command" << std::endl;
+            headerLoaded = false;
+        }
+        
+        // Compressed files locate blocks through the block map
+        if (headerLoaded && isCompressed() && !blockMap.load(getBlockMapFileName())) {
+            std::cerr << "Error: Could not read block map " << getBlockMapFileName() << std::endl;
+            headerLoaded = false;
+        }
+        
+        // Dictionary-encoded records need the string table loaded once at open
+        if (headerLoaded && getRecordFormat() == RECORD_FORMAT_DICTIONARY &&
+            !dictionary.load(getDictionaryFileName())) {
+            std::cerr << "Error: Could not read dictionary " << getDictionaryFileName() << std::endl;
+            headerLoaded = false;
+        }
+
+        // The direct-address table is mapped, not parsed, so opening it costs nothing per Zip Code
+        if (headerLoaded && isDirectIndexed() && !directIndex.load(getDirectIndexFileName())) {
+            std::cerr << "Error: Could not read direct index " << getDirectIndexFileName() << std::endl;
+            headerLoaded = false;
+        }
+        return headerLoaded;
+    }
+    
+    /**
+     * @brief Write the header (and the block map, if changed) to the data file
+     * @return true if successful, false otherwise
+     */
+    bool writeHeader() {
+        std::ofstream headerFile(dataFileName, std::ios::binary | std::ios::in | std::ios::out);
+        bool success = header.write(headerFile);
+        headerFile.close();
+        
+        if (isCompressed() && blockMap.isDirty()) {
+            success = blockMap.save(getBlockMapFileName()) && success;
+        }
+        if (getRecordFormat() == RECORD_FORMAT_DICTIONARY && dictionary.isDirty()) {
+            success = dictionary.save(getDictionaryFileName()) && success;
+        }
+        if (isDirectIndexed() && directIndex.isDirty()) {
+            success = directIndex.save(getDirectIndexFileName()) && success;
+        }
+        if (aggregates.isLoaded() && aggregates.isDirty()) {
+            success = aggregates.save(getAggregatesFileName()) && success;
+        }
+
+        // Records moved, so the spatial index is rebuilt on the next nearest query
+        invalidateSpatialIndex();
+        return success;
+    }
+    
+    /**
+     * @brief Check if blocks are stored compressed
+     * @return true if the header selects a compression codec
+     */
+    bool isCompressed() const {
+        return BlockCodec::fromName(header.getCompressionType()) != CODEC_NONE;
+    }
+    
+    /**
+     * @brief Get the name of the block map file for compressed data files
+     * @return The block map file name
+     */
+    std::string getBlockMapFileName() const {
+        return dataFileName + ".map";
+    }
+    
+    /**
+     * @brief Get the name of the dictionary file for dictionary-encoded data files
+     * @return The dictionary file name
+     */
+    std::string getDictionaryFileName() const {
+        return dataFileName + ".dict";
+    }
+    
+    /**
+     * @brief Check if the file keeps a direct-address Zip Code → RBN table
+     * @return true if the header selects the direct index mode
+     */
+    bool isDirectIndexed() const {
+        return header.getIndexMode() == "direct";
+    }
+
+    /**
+     * @brief Check if records are ordered by location instead of Zip Code
+     *
+     * In Hilbert layout blocks follow a Hilbert curve over latitude and
+     * longitude, so the index keeps an entry for every Zip Code rather than
+     * one per block. Records inside a block stay in Zip Code order.
+     * @return true if the header selects the hilbert layout
+     */
+    bool isHilbertLayout() const {
+        return header.getLayout() == "hilbert";
+    }
+
+    /**
+     * @brief Get the name of the direct-address table file
+     * @return The direct index file name
+     */
+    std::string getDirectIndexFileName() const {
+        return indexFileName + ".direct";
+    }
+
+    /**
+     * @brief Check if block lookups use a learned model of the index
+     * @return true if the header selects the learned index mode
+     */
+    bool isLearnedIndexed() const {
+        return header.getIndexMode() == "learned";
+    }
+
+    /**
+     * @brief Get the name of the learned model file
+     * @return The learned model file name
+     */
+    std::string getLearnedIndexFileName() const {
+        return indexFileName + ".learned";
+    }
+
+    /**
+     * @brief Get the name of the spatial index file
+     * @return The k-d tree file name
+     */
+    std::string getSpatialIndexFileName() const {
+        return indexFileName + ".kdtree";
+    }
+
+    /**
+     * @brief Get the name of the Z-order (geohash) index file
+     * @return The Z-order index file name
+     */
+    std::string getGeoIndexFileName() const {
+        return indexFileName + ".geo";
+    }
+
+    /**
+     * @brief Get the name of the per-state summaries file
+     * @return The summaries file name
+     */
+    std::string getAggregatesFileName() const {
+        return dataFileName + ".states";
+    }
+
+    /**
+     * @brief Load the per-state summaries if they are not loaded yet
+     * @return true if the summaries are available to update, false if the file has none
+     */
+    bool loadAggregates() {
+        return aggregates.isLoaded() || aggregates.load(getAggregatesFileName());
+    }
+
+    /**
+     * @brief Round a coordinate to the six significant digits a CSV payload keeps
+     *
+     * Formats like the default stream output (%g) and parses like BlockView,
+     * without the stream a bulk load would otherwise build for every record.
+     * @param value The coordinate
+     * @return The coordinate as it reads back from a CSV payload
+     */
+    static double roundToCSVPrecision(double value) {
+        char text[32];
+        char* end = std::to_chars(text, text + sizeof(text), value, std::chars_format::general, 6).ptr;
+        std::from_chars(text, end, value);
+        return value;
+    }
+
+    /**
+     * @brief Fold a record being written into the per-state summaries
+     *
+     * CSV payloads keep coordinates to six significant digits, so the
+     * record is summarized as it will read back, and summaries kept while
+     * writing agree with summaries rebuilt by scanning the file.
+     * @param record The record
+     */
+    void addToAggregates(const ZipCodeRecord& record) {
+        double latitude = record.getLatitude();
+        double longitude = record.getLongitude();
+        if (getRecordFormat() == RECORD_FORMAT_CSV) {
+            latitude = roundToCSVPrecision(latitude);
+            longitude = roundToCSVPrecision(longitude);
+        }
+        aggregates.add(record.getStateName(), record.getZipCode(), latitude, longitude);
+    }
+
+    /**
+     * @brief Make the per-state summaries current for reading
+     *
+     * Summaries missing from the file (older files) are built with one scan
+     * of the sequence set. States whose extreme was deleted are recomputed,
+     * all in the same scan, and the result is saved.
+     * @return true if successful, false otherwise
+     */
+    bool refreshAggregates() {
+        if (!readHeader()) {
+            return false;
+        }
+        if (!loadAggregates()) {
+            aggregates.clear();
+            if (!forEachRecord([this](const RecordView& record, int) {
+                    aggregates.add(record.getStateName(), record.getZipCode(), record.getLatitude(),
+                                   record.getLongitude());
+                })) {
+                return false;
+            }
+        } else if (aggregates.hasStale()) {
+            std::map<std::string, StateAggregates::Summary, std::less<>> fresh;
+            for (const auto& entry : aggregates.getStates()) {
+                if (entry.second.stale) {
+                    fresh[entry.first].state = entry.first;
+                }
+            }
+            if (!forEachRecord([&fresh](const RecordView& record, int) {
+                    auto it = fresh.find(record.getStateName());
+                    if (it != fresh.end()) {
+                        StateAggregates::accumulate(it->second, record.getZipCode(), record.getLatitude(),
+                                                    record.getLongitude());
+                    }
+                })) {
+                return false;
+            }
+            for (const auto& entry : fresh) {
+                aggregates.replace(entry.second);
+            }
+        }
+        if (aggregates.isDirty() && !aggregates.save(getAggregatesFileName())) {
+            std::cerr << "Error: Could not write state summaries " << getAggregatesFileName() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Discard the spatial indexes after records change
+     */
+    void invalidateSpatialIndex() {
+        spatialIndex.clear();
+        geoIndex.clear();
+        std::remove(getSpatialIndexFileName().c_str());
+        std::remove(getGeoIndexFileName().c_str());
+    }
+
+    /**
+     * @brief Call a function with every record and its block, in sequence set order
+     * @param visit Called as visit(record, rbn) with a RecordView
+     * @return true if the header could be read
+     */
+    template <typename Visit>
+    bool forEachRecord(Visit visit) {
+        if (!readHeader()) {
+            return false;
+        }
+        std::ifstream file(dataFileName, std::ios::binary);
+        std::set<int> visited;
+        BlockBuffer block = makeBlock();
+        int rbn = header.getActiveListHead();
+        while (rbn >= 0 && !visited.count(rbn)) {
+            visited.insert(rbn);
+            if (!block.readRaw(file, rbn, header.getHeaderRecordSize())) {
+                break;
+            }
+
+            BlockView view(block);
+            for (RecordView record : view) {
+                visit(record, rbn);
+            }
+            rbn = view.getNextBlockRBN();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Call a function with the location and block of every record, in sequence set order
+     * @param visit Called as visit(zipCode, latitude, longitude, rbn)
+     * @return true if the header could be read
+     */
+    template <typename Visit>
+    bool forEachLocation(Visit visit) {
+        return forEachRecord([&visit](const RecordView& record, int rbn) {
+            visit(record.getZipCode(), record.getLatitude(), record.getLongitude(), rbn);
+        });
+    }
+
+    /**
+     * @brief Read the records of Z-order index matches, one block read per distinct block
+     * @param matches The matches
+     * @param results Output parameter for the records, in match order
+     * @param distancesKm Output parameter for the match distances, or nullptr
+     */
+    void resolveMatches(const std::vector<ZipGeoIndex::Match>& matches, std::vector<ZipCodeRecord>& results,
+                        std::vector<double>* distancesKm) {
+        std::map<int, std::vector<size_t>> byBlock;
+        for (size_t i = 0; i < matches.size(); i++) {
+            byBlock[matches[i].rbn].push_back(i);
+        }
+
+        if (!searchFile.is_open()) {
+            searchFile.open(dataFileName, std::ios::binary);
+        }
+        std::vector<ZipCodeRecord> records(matches.size());
+        std::vector<bool> found(matches.size(), false);
+        BlockBuffer block = makeBlock();
+        for (const auto& entry : byBlock) {
+            searchFile.clear();
+            if (!block.readRaw(searchFile, entry.first, header.getHeaderRecordSize())) {
+                continue;
+            }
+            BlockView view(block);
+            for (size_t i : entry.second) {
+                RecordView match;
+                if (view.findRecord(matches[i].zipCode, match)) {
+                    records[i] = match.toRecord();
+                    found[i] = true;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < matches.size(); i++) {
+            if (found[i]) {
+                results.push_back(std::move(records[i]));
+                if (distancesKm) {
+                    distancesKm->push_back(matches[i].distanceKm);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Make the Z-order index available, loading it or building and saving it
+     * @return true if the index can be searched
+     */
+    bool openGeoIndex() {
+        if (!readHeader()) {
+            return false;
+        }
+        if (geoIndex.isOpen() || geoIndex.load(getGeoIndexFileName())) {
+            return true;
+        }
+        geoIndex.clear();
+        if (!forEachLocation([this](std::string_view zipCode, double latitude, double longitude, int rbn) {
+                geoIndex.add(zipCode, latitude, longitude, rbn);
+            })) {
+            return false;
+        }
+        geoIndex.build();
+        if (!geoIndex.save(getGeoIndexFileName())) {
+            std::cerr << "Error: Could not write geo index " << getGeoIndexFileName() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Rebuild the flat copy of the index that the learned model searches
+     *
+     * The highest keys are mapped to integers in index (string) order, so
+     * the model can be a plain numeric fit. A saved model is reused when it
+     * was fitted on the same keys; otherwise the model is fitted and saved.
+     * Keys that are not Zip Codes leave the arrays empty, and lookups fall
+     * back to scanning the index.
+     * @param loadSaved Whether to try the saved model first
+     */
+    void rebuildLearnedIndex(bool loadSaved) {
+        learnedKeys.clear();
+        learnedRBNs.clear();
+        learnedKeys.reserve(index.size());
+        learnedRBNs.reserve(index.size());
+        for (const auto& pair : index) {
+            uint64_t orderKey;
+            if (!CompactZipCodeRecord::zipOrderKey(pair.first, orderKey)) {
+                learnedKeys.clear();
+                learnedRBNs.clear();
+                return;
+            }
+            learnedKeys.push_back(orderKey);
+            learnedRBNs.push_back(pair.second);
+        }
+
+        auto keyAt = [this](size_t i) { return learnedKeys[i]; };
+        if (loadSaved) {
+            MappedFile saved(getLearnedIndexFileName());
+            if (saved.isOpen() && learnedIndex.deserialize(saved.data(), saved.size()) &&
+                learnedIndex.matches(learnedKeys.size(), keyAt)) {
+                return;
+            }
+        }
+
+        learnedIndex.fit(learnedKeys.size(), keyAt);
+        std::string model;
+        learnedIndex.serialize(model);
+        std::ofstream file(getLearnedIndexFileName(), std::ios::binary | std::ios::trunc);
+        file.write(model.data(), model.size());
+    }
+
+    /**
+     * @brief Get the direct-address slot of a Zip Code
+     *
+     * Only Zip Codes written without leading zeros get a slot, so each slot
+     * belongs to exactly one key string; other keys use the block index.
+     * @param zipCode The Zip Code
+     * @param slot Output parameter for the slot
+     * @return true if the file is direct indexed and the Zip Code has a slot
+     */
+    bool getDirectSlot(const std::string& zipCode, uint32_t& slot) const {
+        return isDirectIndexed() && (zipCode.size() == 1 || zipCode[0] != '0') &&
+               DirectZipTable::slotFor(zipCode, slot);
+    }
+
+    /**
+     * @brief Record which block holds a Zip Code (no-op unless direct indexed)
+     * @param zipCode The Zip Code
+     * @param rbn The RBN of its block, or DirectZipTable::NO_ENTRY if removed
+     */
+    void setDirectEntry(const std::string& zipCode, int64_t rbn) {
+        uint32_t slot;
+        if (getDirectSlot(zipCode, slot)) {
+            directIndex.set(slot, rbn);
+        }
+    }
+
+    /**
+     * @brief Get the record format selected in the header
+     * @return The record format
+     */
+    RecordFormat getRecordFormat() const {
+        const std::string& type = header.getRecordFormatType();
+        if (type == "binary") return RECORD_FORMAT_BINARY;
+        if (type == "dictionary") return RECORD_FORMAT_DICTIONARY;
+        return RECORD_FORMAT_CSV;
+    }
+    
+    /**
+     * @brief Create an empty block using the header's block and record settings
+     * @return The new block
+     */
+    BlockBuffer makeBlock() {
+        BlockBuffer block(header.getBlockSize(), header.getRecordSizeBytes(),
+                          header.getSizeFormatType() == "binary", getRecordFormat());
+        if (isCompressed()) {
+            block.setBlockMap(&blockMap);
+        }
+        if (getRecordFormat() == RECORD_FORMAT_DICTIONARY) {
+            block.setDictionary(&dictionary);
+        }
+        return block;
+    }
 
     /**
      * @brief Read the index from file
@@ -42,17 +538,28 @@ private:
             return false;
         }
         
+        // Later lines override earlier ones, and an RBN of -1 removes the key (see appendIndexEntries)
         std::string line;
+        size_t lines = 0;
         while (std::getline(file, line)) {
             size_t commaPos = line.find(',');
             if (commaPos != std::string::npos) {
                 std::string key = line.substr(0, commaPos);
                 int rbn = std::stoi(line.substr(commaPos + 1));
-                index[key] = rbn;
+                if (rbn < 0) {
+                    index.erase(key);
+                } else {
+                    index[key] = rbn;
+                }
+                lines++;
             }
         }
+        indexLogEntries = lines - index.size();
         
         file.close();
+        if (isLearnedIndexed()) {
+            rebuildLearnedIndex(true);
+        }
         return true;
     }
     
@@ -68,9 +575,36 @@ private:
         for (const auto& pair : sorted) {
             file << pair.first << "," << pair.second << "\n";
         }
+        indexLogEntries = 0;
+        if (isLearnedIndexed()) {
+            rebuildLearnedIndex(false);
+        }
         return true;
     }
     
+    /**
+     * @brief Record index changes by appending them to the index file
+     *
+     * The Hilbert layout changes an entry on every insert and remove, so
+     * the changed lines are appended (RBN -1 for a removed key) instead of
+     * rewriting the whole file. The file is rewritten once the appended
+     * lines outnumber the entries, or when a learned model must be refitted.
+     * @param entries Changed keys and their RBNs (already applied to the index)
+     * @return true if successful, false otherwise
+     */
+    bool appendIndexEntries(const std::vector<std::pair<std::string, int>>& entries) {
+        if (isLearnedIndexed() || indexLogEntries + entries.size() > index.size()) {
+            return writeIndex();
+        }
+        std::ofstream file(indexFileName, std::ios::app);
+        if (!file.is_open()) return false;
+        for (const auto& entry : entries) {
+            file << entry.first << "," << entry.second << "\n";
+        }
+        indexLogEntries += entries.size();
+        return true;
+    }
+
     /**
      * @brief Find a block by key using the index
      * @param key The key to search for
@@ -78,16 +612,23 @@ private:
      */
     int findBlockByKey(const std::string& key) {
         if (index.empty()) readIndex();
+
+        // Learned mode: the model predicts the entry's position, and only a small window is searched
+        uint64_t orderKey;
+        if (!learnedRBNs.empty() && isLearnedIndexed() && CompactZipCodeRecord::zipOrderKey(key, orderKey)) {
+            size_t position = learnedIndex.lowerBound(orderKey, [this](size_t i) { return learnedKeys[i]; });
+            return position < learnedRBNs.size() ? learnedRBNs[position] : learnedRBNs.back();
+        }
     
-        // Linear scan: find first block whose highest key is >= the search key
-        for (const auto& pair : index) {
-            if (key <= pair.first) {
-                return pair.second;
-            }
+        // Find first block whose highest key is >= the search key (in Hilbert layout,
+        // the key's own block, or the block of the next larger key for a new key)
+        auto entry = index.lower_bound(key);
+        if (entry != index.end()) {
+            return entry->second;
         }
     
-        // If not found, return last block
-        return std::prev(index.end())->second;
+        // If not found, return last block (or -1 if the file has no blocks)
+        return index.empty() ? -1 : std::prev(index.end())->second;
     }
     
     
@@ -116,7 +657,7 @@ private:
         
         if (availHead >= 0) {
             // Use a block from the avail list
-            BlockBuffer block(header.getBlockSize(), header.getRecordSizeBytes());
+            BlockBuffer block = makeBlock();
             std::ifstream file(dataFileName, std::ios::binary);
             block.read(file, availHead, header.getHeaderRecordSize());
             file.close();
@@ -136,7 +677,7 @@ private:
      * @param rbn The RBN of the block to add
      */
     void addToAvailList(int rbn) {
-        BlockBuffer block(header.getBlockSize(), header.getRecordSizeBytes());
+        BlockBuffer block = makeBlock();
         
         // Read the block
         std::ifstream readFile(dataFileName, std::ios::binary);
@@ -156,9 +697,7 @@ private:
         writeFile.close();
         
         // Update header
-        std::ofstream headerFile(dataFileName, std::ios::binary | std::ios::in | std::ios::out);
-        header.write(headerFile);
-        headerFile.close();
+        writeHeader();
     }
 
 public:
@@ -168,17 +707,60 @@ public:
      * @param indexFile Name of the index file
      */
     BSSManager(const std::string& dataFile, const std::string& indexFile)
-        : dataFileName(dataFile), indexFileName(indexFile) {
+        : dataFileName(dataFile), indexFileName(indexFile), indexLogEntries(0), headerLoaded(false), verbose(true) {
+    }
+
+    /**
+     * @brief Set whether search and insert report the blocks they read and split on standard output
+     * @param enabled false for long-lived processes and library use, where stdout is not ours
+     */
+    void setVerbose(bool enabled) {
+        verbose = enabled;
+    }
+
+    /**
+     * @brief Load the header and index of an existing file
+     *
+     * Other operations load them on first use; calling this first tells a
+     * caller up front whether the files are usable.
+     * @return true if successful, false if either file is missing or invalid
+     */
+    bool open() {
+        return readHeader() && readIndex();
     }
     
     /**
      * @brief Initialize a new blocked sequence set file
      * @param blockSize Size of blocks in bytes
+     * @param recordFormat Record payload format, "CSV", "binary" or "dictionary"
+     * @param compression Block compression codec, "none", "lz" or "zstd"
+     * @param indexMode Primary index mode, "blocks" (highest key per block), "direct"
+     *                  (also keep a Zip Code → RBN table for one-read lookups) or "learned"
+     *                  (search the block index through a piecewise-linear model)
+     * @param layout Physical record order, "zip" or "hilbert" (blocks follow a Hilbert
+     *               curve over latitude/longitude, for spatially local workloads)
      * @return true if successful, false otherwise
      */
-    bool initialize(int blockSize = 512) {
+    bool initialize(int blockSize = 512, const std::string& recordFormat = "CSV",
+                    const std::string& compression = "none", const std::string& indexMode = "blocks",
+                    const std::string& layout = "zip") {
+        BlockCodecType codec = BlockCodec::fromName(compression);
+        if (!BlockCodec::isAvailable(codec)) {
+            std::cerr << "Error: Compression " << compression << " is not available in this build" << std::endl;
+            return false;
+        }
+        
         // Set up header
         header.setBlockSize(blockSize);
+        header.setRecordFormatType(recordFormat);
+        header.setCompressionType(codec == CODEC_NONE ? "none" : compression);
+        header.setIndexMode(indexMode == "direct" || indexMode == "learned" ? indexMode : "blocks");
+        header.setLayout(layout == "hilbert" ? "hilbert" : "zip");
+        if (recordFormat == "binary") {
+            header.setFieldTypes({"uint32", "varstring", "varstring", "varstring", "fixed6", "fixed6"});
+        } else if (recordFormat == "dictionary") {
+            header.setFieldTypes({"uint32", "dictcode", "dictcode", "dictcode", "fixed6", "fixed6"});
+        }
         header.setIndexFileName(indexFileName);
         header.setRecordCount(0);
         header.setBlockCount(0);
@@ -187,6 +769,8 @@ public:
         header.setHeaderRecordSize(header.calculateHeaderSize());
         
         // Create and write header to file
+        searchFile.close();
+        invalidateSpatialIndex();
         std::ofstream file(dataFileName, std::ios::binary | std::ios::trunc);
         if (!file.is_open()) {
             return false;
@@ -194,7 +778,30 @@ public:
         
         bool success = header.write(file);
         file.close();
+        headerLoaded = success;
         
+        // Start an empty block map right after the header
+        if (isCompressed()) {
+            blockMap.reset(codec, header.getHeaderRecordSize());
+            success = blockMap.save(getBlockMapFileName()) && success;
+        }
+        
+        // Start an empty dictionary
+        if (getRecordFormat() == RECORD_FORMAT_DICTIONARY) {
+            dictionary.clear();
+            success = dictionary.save(getDictionaryFileName()) && success;
+        }
+        
+        // Start an empty direct-address table
+        if (isDirectIndexed()) {
+            directIndex.reset();
+            success = directIndex.save(getDirectIndexFileName()) && success;
+        }
+
+        // Start with no states
+        aggregates.clear();
+        success = aggregates.save(getAggregatesFileName()) && success;
+
         // Create empty index file
         std::ofstream indexFile(indexFileName, std::ios::trunc);
         indexFile.close();
@@ -209,29 +816,48 @@ public:
      */
     bool createFromCSV(const std::string& csvFileName) {
         // Open CSV file
-        std::ifstream csvFile(csvFileName);
-        if (!csvFile.is_open()) {
+        MappedFile csvFile(csvFileName);
+        if (!csvFile.isOpen()) {
             std::cerr << "Error: Could not open CSV file " << csvFileName << std::endl;
             return false;
         }
         
-        // Read CSV file
-        std::vector<ZipCodeRecord> records;
-        std::string line;
+        // Read CSV file into compact records; names are interned once per distinct string
+        RecordDictionary names;
+        std::vector<CompactZipCodeRecord> records;
+        CSVBulkReader reader(csvFile.data(), csvFile.size());
+        std::string_view line;
         
         // Skip header line
-        std::getline(csvFile, line);
+        reader.nextRecord(line);
         
         // Read data lines
-        while (std::getline(csvFile, line)) {
-            ZipCodeRecord record = ZipCodeRecord::fromCSV(line);
-            records.push_back(record);
+        CompactZipCodeRecord compact;
+        while (reader.nextRecord(line)) {
+            if (!compact.assignFields(reader, names)) {
+                std::cerr << "Warning: Skipping record with invalid Zip Code or state: " << line << std::endl;
+                continue;
+            }
+            records.push_back(compact);
         }
         
         csvFile.close();
         
-        // Sort records by Zip Code
-        std::sort(records.begin(), records.end());
+        // Sort records by Zip Code: radix sort the keys, then move each record once
+        std::vector<uint64_t> keys(records.size());
+        for (size_t i = 0; i < records.size(); i++) {
+            keys[i] = records[i].getZipOrderKey();
+        }
+        RecordSort::applyOrder(records, RecordSort::radixOrder(keys));
+        
+        // Hilbert layout: order by position along the curve instead (ties stay in Zip Code order)
+        bool hilbert = header.getLayout() == "hilbert";
+        if (hilbert) {
+            for (size_t i = 0; i < records.size(); i++) {
+                keys[i] = ZipGeoIndex::hilbertKey(records[i].getLatitude(), records[i].getLongitude());
+            }
+            RecordSort::applyOrder(records, RecordSort::radixOrder(keys));
+        }
         
         // Create blocked sequence set file
         std::ofstream dataFile(dataFileName, std::ios::binary | std::ios::in | std::ios::out);
@@ -241,20 +867,25 @@ public:
         }
         
         // Read header
-        std::ifstream headerFile(dataFileName, std::ios::binary);
-        header.read(headerFile);
-        headerFile.close();
+        headerLoaded = false;
+        if (!readHeader()) {
+            std::cerr << "Error: Could not read header of " << dataFileName << std::endl;
+            return false;
+        }
         
         // Process records
-        int blockSize = header.getBlockSize();
-        int recordSizeBytes = header.getRecordSizeBytes();
-        bool isBinary = (header.getSizeFormatType() == "binary");
-        
-        BlockBuffer currentBlock(blockSize, recordSizeBytes, isBinary);
+        BlockBuffer currentBlock = makeBlock();
         int currentRBN = 0;
         int prevRBN = -1;
+        int recordCount = 0;
         
-        for (const auto& record : records) {
+        ZipCodeRecord record;
+        aggregates.clear();
+        for (const auto& entry : records) {
+            entry.copyTo(record, names);
+            recordCount++;
+            addToAggregates(record);
+            
             // If block is full, write it and create a new one
             if (!currentBlock.addRecord(record)) {
                 // Update RBN links
@@ -265,16 +896,22 @@ public:
                 currentBlock.write(dataFile, currentRBN, header.getHeaderRecordSize());
                 
                 // Add to index
-                index[currentBlock.getHighestKey()] = currentRBN;
+                if (!hilbert) {
+                    index[currentBlock.getHighestKey()] = currentRBN;
+                }
                 
                 // Move to next block
                 prevRBN = currentRBN;
                 currentRBN++;
                 
                 // Create new block
-                currentBlock = BlockBuffer(blockSize, recordSizeBytes, isBinary);
+                currentBlock = makeBlock();
                 currentBlock.addRecord(record);
             }
+            setDirectEntry(record.getZipCode(), currentRBN);
+            if (hilbert) {
+                index[record.getZipCode()] = currentRBN;
+            }
         }
         
         // Write the last block
@@ -283,16 +920,38 @@ public:
         currentBlock.write(dataFile, currentRBN, header.getHeaderRecordSize());
         
         // Add to index
-        index[currentBlock.getHighestKey()] = currentRBN;
+        if (!hilbert) {
+            index[currentBlock.getHighestKey()] = currentRBN;
+        }
         
         // Update header
-        header.setRecordCount(records.size());
+        header.setRecordCount(recordCount);
         header.setBlockCount(currentRBN + 1);
         header.setActiveListHead(0);
         header.write(dataFile);
         
         dataFile.close();
         
+        if (isCompressed() && !blockMap.save(getBlockMapFileName())) {
+            std::cerr << "Error: Could not write block map " << getBlockMapFileName() << std::endl;
+            return false;
+        }
+        
+        if (getRecordFormat() == RECORD_FORMAT_DICTIONARY && !dictionary.save(getDictionaryFileName())) {
+            std::cerr << "Error: Could not write dictionary " << getDictionaryFileName() << std::endl;
+            return false;
+        }
+
+        if (isDirectIndexed() && !directIndex.save(getDirectIndexFileName())) {
+            std::cerr << "Error: Could not write direct index " << getDirectIndexFileName() << std::endl;
+            return false;
+        }
+
+        if (!aggregates.save(getAggregatesFileName())) {
+            std::cerr << "Error: Could not write state summaries " << getAggregatesFileName() << std::endl;
+            return false;
+        }
+
         // Write index
         return writeIndex();
     }
@@ -304,23 +963,52 @@ public:
      * @return true if record was found, false otherwise
      */
     bool search(const std::string& zipCode, ZipCodeRecord& result) {
-        // Find block using index
-        int rbn = findBlockByKey(zipCode);
+        if (!readHeader()) {
+            return false;
+        }
         
-        // Read block
-        BlockBuffer block(header.getBlockSize(), header.getRecordSizeBytes());
-        std::ifstream file(dataFileName, std::ios::binary);
-        block.read(file, rbn + 2, header.getHeaderRecordSize());
-        file.close();
+        // Find block using the direct-address table (one array read) or the block index
+        int rbn;
+        uint32_t slot;
+        if (getDirectSlot(zipCode, slot)) {
+            int64_t entry = directIndex.get(slot);
+            if (entry == DirectZipTable::NO_ENTRY) {
+                return false;
+            }
+            rbn = static_cast<int>(entry);
+        } else {
+            rbn = findBlockByKey(zipCode);
+        }
+        if (rbn < 0) {
+            return false;
+        }
+
+        // Read block bytes without unpacking every record, through a data file handle kept open
+        BlockBuffer block = makeBlock();
+        if (!searchFile.is_open()) {
+            searchFile.open(dataFileName, std::ios::binary);
+        }
+        searchFile.clear();
+        if (!block.readRaw(searchFile, rbn, header.getHeaderRecordSize())) {
+            return false;
+        }
         
-        std::cout << "Block RBN being searched: " << rbn << std::endl;
-        for (const auto& r : block.getRecords()) {
-            std::cout << "   contains zip: [" << r.getZipCode() << "]" << std::endl;
+        BlockView view(block);
+        if (verbose) {
+            std::cout << "Block RBN being searched: " << rbn << std::endl;
+            for (RecordView r : view) {
+                std::cout << "   contains zip: [" << r.getZipCode() << "]" << std::endl;
+            }
         }
 
 
-        // Search for record in block
-        return block.findRecord(zipCode, result);
+        // Binary-search the block in place, materializing only the match
+        RecordView match;
+        if (!view.findRecord(zipCode, match)) {
+            return false;
+        }
+        result = match.toRecord();
+        return true;
     }
     
     /**
@@ -329,6 +1017,10 @@ public:
      * @return true if successful, false otherwise
      */
     bool insert(const ZipCodeRecord& record) {
+        if (!readHeader()) {
+            return false;
+        }
+        
         std::string zipCode = record.getZipCode();
     
         // Check if record already exists
@@ -342,52 +1034,60 @@ public:
         int rbn = findBlockByKey(zipCode);
     
         // Read block
-        BlockBuffer block(header.getBlockSize(), header.getRecordSizeBytes());
+        BlockBuffer block = makeBlock();
         std::ifstream readFile(dataFileName, std::ios::binary);
-        block.read(readFile, rbn + 2, header.getHeaderRecordSize());
+        block.read(readFile, rbn, header.getHeaderRecordSize());
         readFile.close();
+        
+        std::string oldHighest = block.getHighestKey();
+        int nextRBN = block.getNextBlockRBN();
     
         if (block.addRecord(record)) {
             std::ofstream writeFile(dataFileName, std::ios::binary | std::ios::in | std::ios::out);
-            block.write(writeFile, rbn + 2, header.getHeaderRecordSize());
+            block.write(writeFile, rbn, header.getHeaderRecordSize());
             writeFile.close();
     
-            std::string oldHighest = block.getHighestKey();
-            if (zipCode > oldHighest) {
-                updateIndex(oldHighest, zipCode, rbn);
+            if (isHilbertLayout()) {
+                index[zipCode] = rbn;
+                appendIndexEntries({{zipCode, rbn}});
+            } else if (block.getHighestKey() != oldHighest) {
+                updateIndex(oldHighest, block.getHighestKey(), rbn);
             }
-    
+            setDirectEntry(zipCode, rbn);
+            if (loadAggregates()) {
+                addToAggregates(record);
+            }
+
             header.setRecordCount(header.getRecordCount() + 1);
-            std::ofstream headerFile(dataFileName, std::ios::binary | std::ios::in | std::ios::out);
-            header.write(headerFile);
-            headerFile.close();
+            writeHeader();
     
             return true;
         } else {
-            BlockBuffer newBlock(header.getBlockSize(), header.getRecordSizeBytes());
+            BlockBuffer newBlock = makeBlock();
             if (!block.split(newBlock)) {
                 std::cerr << "Error: Could not split block" << std::endl;
                 return false;
             }
     
             int newRBN = getNewBlockRBN();
-            std::cout << "Block split: Block " << rbn << " split into blocks " << rbn << " and " << newRBN << std::endl;
+            if (verbose) {
+                std::cout << "Block split: Block " << rbn << " split into blocks " << rbn << " and " << newRBN << std::endl;
+            }
     
-            int nextRBN = block.getNextBlockRBN();
             block.setNextBlockRBN(newRBN);
             newBlock.setPrevBlockRBN(rbn);
             newBlock.setNextBlockRBN(nextRBN);
     
             if (nextRBN >= 0) {
-                BlockBuffer nextBlock(header.getBlockSize(), header.getRecordSizeBytes());
+                BlockBuffer nextBlock = makeBlock();
                 std::ifstream nextReadFile(dataFileName, std::ios::binary);
-                nextBlock.read(nextReadFile, nextRBN + 2, header.getHeaderRecordSize());
+                nextBlock.read(nextReadFile, nextRBN, header.getHeaderRecordSize());
                 nextReadFile.close();
     
                 nextBlock.setPrevBlockRBN(newRBN);
     
                 std::ofstream nextWriteFile(dataFileName, std::ios::binary | std::ios::in | std::ios::out);
-                nextBlock.write(nextWriteFile, nextRBN + 2, header.getHeaderRecordSize());
+                nextBlock.write(nextWriteFile, nextRBN, header.getHeaderRecordSize());
                 nextWriteFile.close();
             }
     
@@ -404,17 +1104,40 @@ public:
             }
     
             std::ofstream writeFile(dataFileName, std::ios::binary | std::ios::in | std::ios::out);
-            block.write(writeFile, rbn + 2, header.getHeaderRecordSize());
-            newBlock.write(writeFile, newRBN + 2, header.getHeaderRecordSize());
+            block.write(writeFile, rbn, header.getHeaderRecordSize());
+            newBlock.write(writeFile, newRBN, header.getHeaderRecordSize());
             writeFile.close();
     
-            std::string oldHighest = block.getHighestKey();
-            if (oldHighest != block.getHighestKey()) {
+            if (isHilbertLayout()) {
+                // Every moved Zip Code has its own entry
+                std::vector<std::pair<std::string, int>> changed;
+                for (const auto& moved : newBlock.getRecords()) {
+                    changed.emplace_back(moved.getZipCode(), newRBN);
+                }
+                if (zipCode <= block.getHighestKey()) {
+                    changed.emplace_back(zipCode, rbn);
+                }
+                for (const auto& entry : changed) {
+                    index[entry.first] = entry.second;
+                }
+                appendIndexEntries(changed);
+            } else {
                 index.erase(oldHighest);
                 index[block.getHighestKey()] = rbn;
+                index[newBlock.getHighestKey()] = newRBN;
+                writeIndex();
+            }
+
+            // Records that moved to the new block (and the new record) change RBN
+            for (const auto& moved : newBlock.getRecords()) {
+                setDirectEntry(moved.getZipCode(), newRBN);
+            }
+            if (zipCode <= block.getHighestKey()) {
+                setDirectEntry(zipCode, rbn);
+            }
+            if (loadAggregates()) {
+                addToAggregates(record);
             }
-    
-            index[newBlock.getHighestKey()] = newRBN;
     
             header.setRecordCount(header.getRecordCount() + 1);
             header.setBlockCount(std::max(header.getBlockCount(), std::max(rbn, newRBN) + 1));
@@ -424,9 +1147,7 @@ public:
                 header.setActiveListHead(std::min(rbn, newRBN));
             }
     
-            std::ofstream headerFile(dataFileName, std::ios::binary | std::ios::in | std::ios::out);
-            header.write(headerFile);
-            headerFile.close();
+            writeHeader();
     
             return true;
         }
@@ -439,16 +1160,27 @@ public:
      * @return true if successful, false otherwise
      */
     bool remove(const std::string& zipCode) {
+        if (!readHeader()) {
+            return false;
+        }
+        
         // Find block using index
         int rbn = findBlockByKey(zipCode);
         
         // Read block
-        BlockBuffer block(header.getBlockSize(), header.getRecordSizeBytes());
+        BlockBuffer block = makeBlock();
         std::ifstream readFile(dataFileName, std::ios::binary);
-        block.read(readFile, rbn + 2, header.getHeaderRecordSize());
+        block.read(readFile, rbn, header.getHeaderRecordSize());
         readFile.close();
         
-        // Try to remove the record
+        // Try to remove the record, keeping a copy for the state summaries
+        ZipCodeRecord removed;
+        for (const auto& record : block.getRecords()) {
+            if (record.getZipCode() == zipCode) {
+                removed = record;
+                break;
+            }
+        }
         if (!block.removeRecord(zipCode)) {
             std::cerr << "Error: Record with Zip Code " << zipCode << " not found" << std::endl;
             return false;
@@ -456,6 +1188,10 @@ public:
         
         // Update record count
         header.setRecordCount(header.getRecordCount() - 1);
+        setDirectEntry(zipCode, DirectZipTable::NO_ENTRY);
+        if (loadAggregates()) {
+            aggregates.remove(removed.getStateName(), zipCode, removed.getLatitude(), removed.getLongitude());
+        }
         
         // Check if block is now empty
         if (block.getRecordCount() == 0) {
@@ -465,7 +1201,7 @@ public:
             
             // Update RBN links
             if (prevRBN >= 0) {
-                BlockBuffer prevBlock(header.getBlockSize(), header.getRecordSizeBytes());
+                BlockBuffer prevBlock = makeBlock();
                 std::ifstream prevReadFile(dataFileName, std::ios::binary);
                 prevBlock.read(prevReadFile, prevRBN, header.getHeaderRecordSize());
                 prevReadFile.close();
@@ -481,7 +1217,7 @@ public:
             }
             
             if (nextRBN >= 0) {
-                BlockBuffer nextBlock(header.getBlockSize(), header.getRecordSizeBytes());
+                BlockBuffer nextBlock = makeBlock();
                 std::ifstream nextReadFile(dataFileName, std::ios::binary);
                 nextBlock.read(nextReadFile, nextRBN, header.getHeaderRecordSize());
                 nextReadFile.close();
@@ -497,7 +1233,12 @@ public:
             addToAvailList(rbn);
             
             // Update index
-            updateIndex(block.getHighestKey(), "", -1);
+            if (isHilbertLayout()) {
+                index.erase(zipCode);
+                appendIndexEntries({{zipCode, -1}});
+            } else {
+                updateIndex(block.getHighestKey(), "", -1);
+            }
             
         } else {
             // Block still has records, just update it
@@ -505,24 +1246,295 @@ public:
             
             // Write block
             std::ofstream writeFile(dataFileName, std::ios::binary | std::ios::in | std::ios::out);
-            block.write(writeFile, rbn + 2, header.getHeaderRecordSize());
+            block.write(writeFile, rbn, header.getHeaderRecordSize());
             writeFile.close();
             
             // Update index if highest key changed
             std::string newHighest = block.getHighestKey();
-            if (oldHighest != newHighest) {
+            if (isHilbertLayout()) {
+                index.erase(zipCode);
+                appendIndexEntries({{zipCode, -1}});
+            } else if (oldHighest != newHighest) {
                 updateIndex(oldHighest, newHighest, rbn);
             }
         }
         
         // Update header
-        std::ofstream headerFile(dataFileName, std::ios::binary | std::ios::in | std::ios::out);
-        header.write(headerFile);
-        headerFile.close();
+        writeHeader();
         
         return true;
     }
     
+    /**
+     * @brief Find all records in a state by scanning the sequence set
+     *
+     * Dictionary-encoded files resolve the state to its code once and
+     * compare integer codes per record.
+     * @param state The state abbreviation
+     * @param results Output parameter for the matching records, in Zip Code order
+     * @return The number of matching records
+     */
+    int findByState(const std::string& state, std::vector<ZipCodeRecord>& results) {
+        results.clear();
+        if (!readHeader()) {
+            return 0;
+        }
+
+        bool useCodes = getRecordFormat() == RECORD_FORMAT_DICTIONARY;
+        uint32_t stateCode = 0;
+        if (useCodes && !dictionary.find(DICT_STATE, state, stateCode)) {
+            return 0;
+        }
+
+        std::ifstream file(dataFileName, std::ios::binary);
+        std::set<int> visited;
+        BlockBuffer block = makeBlock();
+        int rbn = header.getActiveListHead();
+        while (rbn >= 0 && !visited.count(rbn)) {
+            visited.insert(rbn);
+            if (!block.readRaw(file, rbn, header.getHeaderRecordSize())) {
+                break;
+            }
+
+            BlockView view(block);
+            for (RecordView record : view) {
+                uint32_t code = 0;
+                bool match = useCodes ? record.getDictionaryCode(DICT_STATE, code) && code == stateCode
+                                      : record.getStateName() == state;
+                if (match) {
+                    results.push_back(record.toRecord());
+                }
+            }
+            rbn = view.getNextBlockRBN();
+        }
+
+        return results.size();
+    }
+
+    /**
+     * @brief Get the summary of one state without scanning the sequence set
+     *
+     * Summaries are kept up to date by insert and remove. Only a state
+     * whose northern, southern, eastern or western record was deleted is
+     * recomputed, on the first read after the delete.
+     * @param state The state abbreviation
+     * @param summary Output parameter for the summary
+     * @return true if the state has records, false otherwise
+     */
+    bool getStateSummary(const std::string& state, StateAggregates::Summary& summary) {
+        if (!refreshAggregates()) {
+            return false;
+        }
+        const StateAggregates::Summary* found = aggregates.find(state);
+        if (!found) {
+            return false;
+        }
+        summary = *found;
+        return true;
+    }
+
+    /**
+     * @brief Get the summaries of every state with records
+     * @param summaries Output parameter for the summaries, in state order
+     * @return The number of states
+     */
+    int getStateSummaries(std::vector<StateAggregates::Summary>& summaries) {
+        summaries.clear();
+        if (!refreshAggregates()) {
+            return 0;
+        }
+        for (const auto& entry : aggregates.getStates()) {
+            summaries.push_back(entry.second);
+        }
+        return summaries.size();
+    }
+
+    /**
+     * @brief Build the spatial index from the sequence set and save it
+     *
+     * Every record's coordinates are added with the RBN of its block, so a
+     * query result is resolved with one block read.
+     * @return true if successful, false otherwise
+     */
+    bool buildSpatialIndex() {
+        spatialIndex.clear();
+        if (!forEachLocation([this](std::string_view zipCode, double latitude, double longitude, int rbn) {
+                spatialIndex.add(zipCode, latitude, longitude, rbn);
+            })) {
+            return false;
+        }
+
+        spatialIndex.build();
+        return spatialIndex.save(getSpatialIndexFileName());
+    }
+
+    /**
+     * @brief Find the records nearest to a location
+     *
+     * Uses the saved spatial index, building it first if it is missing or
+     * was discarded by an insert or remove.
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     * @param k Number of records wanted
+     * @param results Output parameter for the records, nearest first
+     * @param distancesKm Output parameter for each record's great-circle distance in km
+     * @return The number of records found
+     */
+    int nearest(double latitude, double longitude, int k, std::vector<ZipCodeRecord>& results,
+                std::vector<double>& distancesKm) {
+        results.clear();
+        distancesKm.clear();
+        if (k <= 0 || !readHeader()) {
+            return 0;
+        }
+        if (!spatialIndex.isOpen() && !spatialIndex.load(getSpatialIndexFileName()) && !buildSpatialIndex()) {
+            std::cerr << "Error: Could not build spatial index " << getSpatialIndexFileName() << std::endl;
+            return 0;
+        }
+
+        if (!searchFile.is_open()) {
+            searchFile.open(dataFileName, std::ios::binary);
+        }
+        BlockBuffer block = makeBlock();
+        for (const auto& neighbor : spatialIndex.nearest(latitude, longitude, k)) {
+            searchFile.clear();
+            RecordView match;
+            if (block.readRaw(searchFile, neighbor.rbn, header.getHeaderRecordSize()) &&
+                BlockView(block).findRecord(neighbor.zipCode, match)) {
+                results.push_back(match.toRecord());
+                distancesKm.push_back(neighbor.distanceKm);
+            }
+        }
+        return results.size();
+    }
+
+    /**
+     * @brief Find the records within a great-circle distance of a location
+     *
+     * Uses the Z-order index (building it first if needed): the circle's
+     * bounding box becomes a few key ranges, candidates are checked against
+     * the exact distance, and only blocks holding a match are read.
+     * @param latitude Latitude of the centre in degrees
+     * @param longitude Longitude of the centre in degrees
+     * @param radiusKm Radius in km
+     * @param results Output parameter for the records, nearest first
+     * @param distancesKm Output parameter for each record's distance in km
+     * @return The number of records found
+     */
+    int withinRadius(double latitude, double longitude, double radiusKm, std::vector<ZipCodeRecord>& results,
+                     std::vector<double>& distancesKm) {
+        results.clear();
+        distancesKm.clear();
+        if (!openGeoIndex()) {
+            return 0;
+        }
+        resolveMatches(geoIndex.withinRadius(latitude, longitude, radiusKm), results, &distancesKm);
+        return results.size();
+    }
+
+    /**
+     * @brief Find the records inside a latitude/longitude box
+     * @param minLatitude Southern edge in degrees
+     * @param minLongitude Western edge in degrees (greater than maxLongitude if the box crosses the date line)
+     * @param maxLatitude Northern edge in degrees
+     * @param maxLongitude Eastern edge in degrees
+     * @param results Output parameter for the records, in Z-order
+     * @return The number of records found
+     */
+    int withinBox(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude,
+                  std::vector<ZipCodeRecord>& results) {
+        results.clear();
+        if (!openGeoIndex()) {
+            return 0;
+        }
+        resolveMatches(geoIndex.withinBox(minLatitude, minLongitude, maxLatitude, maxLongitude), results, nullptr);
+        return results.size();
+    }
+
+    /**
+     * @brief Get the great-circle distance between every pair of a list of Zip Codes
+     *
+     * Each record is read once; the distances are then computed in one batch
+     * by ZipDistances. Zip Codes that are not in the file are left out.
+     * @param zipCodes The Zip Codes
+     * @param results Output parameter for the records found, in the order given
+     * @param matrixKm Output parameter for the distances in km, row-major:
+     *                 matrixKm[i * results.size() + j] is the distance from results[i] to results[j]
+     * @return The number of records found
+     */
+    int distanceMatrix(const std::vector<std::string>& zipCodes, std::vector<ZipCodeRecord>& results,
+                       std::vector<double>& matrixKm) {
+        results.clear();
+        matrixKm.clear();
+        ZipDistances::Points points;
+        points.reserve(zipCodes.size());
+        ZipCodeRecord record;
+        for (const std::string& zipCode : zipCodes) {
+            if (search(zipCode, record)) {
+                results.push_back(record);
+                points.add(record.getLatitude(), record.getLongitude());
+            }
+        }
+        ZipDistances::manyToMany(points, points, matrixKm);
+        return results.size();
+    }
+
+    /**
+     * @brief Find all records whose Zip Codes fall in a key range
+     *
+     * Starts at the block that would hold startKey and follows the sequence
+     * set until a key passes endKey. Keys compare as strings, the same order
+     * the blocks and the index use.
+     * @param startKey Smallest Zip Code in the range
+     * @param endKey Largest Zip Code in the range
+     * @param results Output parameter for the records, in Zip Code order
+     * @return The number of records found
+     */
+    int rangeSearch(const std::string& startKey, const std::string& endKey, std::vector<ZipCodeRecord>& results) {
+        results.clear();
+        if (!readHeader() || endKey < startKey) {
+            return 0;
+        }
+        
+        // Hilbert layout: the range is contiguous in the index, not in the file
+        if (isHilbertLayout()) {
+            if (index.empty()) readIndex();
+            std::vector<ZipGeoIndex::Match> matches;
+            for (auto entry = index.lower_bound(startKey); entry != index.end() && entry->first <= endKey; ++entry) {
+                matches.push_back(ZipGeoIndex::Match{entry->first, entry->second, 0.0, 0.0, 0.0});
+            }
+            resolveMatches(matches, results, nullptr);
+            return results.size();
+        }
+        int rbn = findBlockByKey(startKey);
+
+        std::ifstream file(dataFileName, std::ios::binary);
+        std::set<int> visited;
+        BlockBuffer block = makeBlock();
+        bool done = false;
+        while (!done && rbn >= 0 && !visited.count(rbn)) {
+            visited.insert(rbn);
+            if (!block.readRaw(file, rbn, header.getHeaderRecordSize())) {
+                break;
+            }
+
+            BlockView view(block);
+            for (RecordView record : view) {
+                std::string_view zipCode = record.getZipCode();
+                if (zipCode > endKey) {
+                    done = true;
+                    break;
+                }
+                if (zipCode >= startKey) {
+                    results.push_back(record.toRecord());
+                }
+            }
+            rbn = view.getNextBlockRBN();
+        }
+
+        return results.size();
+    }
+
     /**
      * @brief Helper function for logging to both out file and terminal
      */
@@ -548,7 +1560,11 @@ public:
             return;
         }
     
-        header.read(file);
+        headerLoaded = false;
+        if (!readHeader()) {
+            out << "Could not read header of data file: " << dataFileName << std::endl;
+            return;
+        }
     
         auto logToBoth = [&](const std::string& message) {
             std::cout << message << std::endl;
@@ -559,19 +1575,20 @@ public:
         logToBoth("Avail Head: " + std::to_string(header.getAvailListHead()));
     
         for (int rbn = 0; rbn < header.getBlockCount(); rbn++) {
-            BlockBuffer block(header.getBlockSize(), header.getRecordSizeBytes());
-            block.read(file, rbn, header.getHeaderRecordSize());
+            BlockBuffer block = makeBlock();
+            block.readRaw(file, rbn, header.getHeaderRecordSize());
+            BlockView view(block);
     
             std::ostringstream line;
             line << "RBN " << std::setw(3) << rbn << "  ";
     
-            if (block.isAvailBlock()) {
-                line << "*available*     -> " << block.getNextBlockRBN();
+            if (view.isAvailBlock()) {
+                line << "*available*     -> " << view.getNextBlockRBN();
             } else {
-                for (const auto& record : block.getRecords()) {
+                for (RecordView record : view) {
                     line << record.getZipCode() << " ";
                 }
-                line << "-> " << block.getNextBlockRBN();  // Link to next
+                line << "-> " << view.getNextBlockRBN();  // Link to next
             }
     
             logToBoth(line.str());
@@ -599,7 +1616,11 @@ public:
             return;
         }
     
-        header.read(file);
+        headerLoaded = false;
+        if (!readHeader()) {
+            out << "Could not read header of data file: " << dataFileName << std::endl;
+            return;
+        }
     
         auto logToBoth = [&](const std::string& message) {
             std::cout << message << std::endl;
@@ -616,18 +1637,19 @@ public:
         while (rbn >= 0 && !visited.count(rbn)) {
             visited.insert(rbn);
     
-            BlockBuffer block(header.getBlockSize(), header.getRecordSizeBytes());
-            block.read(file, rbn, header.getHeaderRecordSize());
+            BlockBuffer block = makeBlock();
+            block.readRaw(file, rbn, header.getHeaderRecordSize());
+            BlockView view(block);
     
             std::ostringstream line;
             line << "RBN " << std::setw(3) << rbn << "  ";
-            for (const auto& record : block.getRecords()) {
+            for (RecordView record : view) {
                 line << record.getZipCode() << " ";
             }
-            line << "-> " << block.getNextBlockRBN();
+            line << "-> " << view.getNextBlockRBN();
             logToBoth(line.str());
     
-            rbn = block.getNextBlockRBN();
+            rbn = view.getNextBlockRBN();
         }
     
         // Dump avail list
@@ -635,7 +1657,7 @@ public:
         while (rbn >= 0 && !visited.count(rbn)) {
             visited.insert(rbn);
     
-            BlockBuffer block(header.getBlockSize(), header.getRecordSizeBytes());
+            BlockBuffer block = makeBlock();
             block.read(file, rbn, header.getHeaderRecordSize());
     
             std::ostringstream line;
@@ -11,12 +11,64 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <cstdint>
+#include <cstring>
 #include "ZipCodeRecord.h"
 #include "RecordBuffer.h"
+#include "BlockMap.h"
+
+/**
+ * @brief Block type tags stored in the block header
+ */
+enum BlockType : uint8_t {
+    BLOCK_TYPE_AVAIL = 0,   ///< Block is on the availability list
+    BLOCK_TYPE_DATA = 1,    ///< Sequence set block holding records
+    BLOCK_TYPE_INDEX = 2    ///< Index block holding key-RBN pairs
+};
+
+/**
+ * @struct BlockHeader
+ * @brief Fixed-size binary header at the start of every block
+ *
+ * Stored little-endian so a block header is decoded with a single memcpy.
+ * RBN links are 64-bit on disk; -1 marks the end of a list. In memory
+ * BlockBuffer, BlockView, BSSManager and the index still hold RBNs as int,
+ * so a file is limited to INT_MAX blocks; the wider field only saves
+ * another format change when they move to 64-bit.
+ */
+struct BlockHeader {
+    uint8_t blockType;      ///< One of the BlockType values
+    uint8_t reserved[3];    ///< Padding, always zero
+    uint32_t recordCount;   ///< Number of records packed in the block
+    uint32_t freeSpace;     ///< Unused bytes after the last packed record
+    uint32_t reserved2;     ///< Padding, always zero
+    int64_t prevRBN;        ///< RBN of the previous block
+    int64_t nextRBN;        ///< RBN of the next block
+};
+
+static_assert(sizeof(BlockHeader) == 32, "BlockHeader must be 32 bytes on disk");
+
+/**
+ * @brief Convert a block header between host and little-endian byte order
+ * @param hdr The header to convert in place (no-op on little-endian hosts)
+ */
+inline void blockHeaderToLittleEndian(BlockHeader& hdr) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    hdr.recordCount = __builtin_bswap32(hdr.recordCount);
+    hdr.freeSpace = __builtin_bswap32(hdr.freeSpace);
+    hdr.prevRBN = static_cast<int64_t>(__builtin_bswap64(static_cast<uint64_t>(hdr.prevRBN)));
+    hdr.nextRBN = static_cast<int64_t>(__builtin_bswap64(static_cast<uint64_t>(hdr.nextRBN)));
+#else
+    (void)hdr;
+#endif
+}
 
 /**
  * @class BlockBuffer
  * @brief Class for reading and writing blocks in the blocked sequence set file
+ *
+ * RBN links are kept as int (see BlockHeader); links read from disk are
+ * narrowed and links written are widened to 64 bits.
  */
 class BlockBuffer {
 private:
@@ -25,60 +77,51 @@ private:
     int prevBlockRBN;                ///< RBN of the previous block
     int nextBlockRBN;                ///< RBN of the next block
     int recordCount;                 ///< Number of records in the block
+    uint8_t blockType;               ///< Block type tag from the header
+    int freeSpace;                   ///< Free bytes recorded in the header
     std::vector<ZipCodeRecord> records; ///< Records in the block
     int headerSize;                  ///< Size of the block header
     int recordSizeBytes;             ///< Number of bytes for record size
     bool isBinary;                   ///< Flag for binary or ASCII format
+    RecordFormat recordFormat;       ///< Encoding of record payloads
+    BlockMap* blockMap;              ///< Extent map for compressed files, or nullptr
+    RecordDictionary* dictionary;    ///< String dictionary for dictionary-encoded records, or nullptr
 
     /**
      * @brief Parse block header from buffer
      */
     void parseHeader() {
-        if (buffer.size() < 12) {
+        if (buffer.size() < sizeof(BlockHeader)) {
             return;
-        };
-
-#endif // BLOCK_BUFFER_H
-        
-        // Extract record count and RBN links
-        std::string countStr = buffer.substr(0, 4);
-        std::string prevStr = buffer.substr(4, 4);
-        std::string nextStr = buffer.substr(8, 4);
-        
-        try {
-            recordCount = std::stoi(countStr);
-            prevBlockRBN = std::stoi(prevStr);
-            nextBlockRBN = std::stoi(nextStr);
-        } catch (...) {
-            recordCount = 0;
-            prevBlockRBN = -1;
-            nextBlockRBN = -1;
         }
+
+        BlockHeader hdr;
+        std::memcpy(&hdr, buffer.data(), sizeof(BlockHeader));
+        blockHeaderToLittleEndian(hdr);
+
+        blockType = hdr.blockType;
+        recordCount = static_cast<int>(hdr.recordCount);
+        freeSpace = static_cast<int>(hdr.freeSpace);
+        prevBlockRBN = static_cast<int>(hdr.prevRBN);
+        nextBlockRBN = static_cast<int>(hdr.nextRBN);
     }
     
     /**
      * @brief Create block header for buffer
      */
     void createHeader() {
-        // Create fixed-size strings for record count and RBN links
-        std::string countStr = std::to_string(recordCount);
-        countStr.insert(0, 4 - countStr.size(), '0');
-        
-        std::string prevStr = std::to_string(prevBlockRBN);
-        prevStr.insert(0, 4 - prevStr.size(), '0');
-        
-        std::string nextStr = std::to_string(nextBlockRBN);
-        nextStr.insert(0, 4 - nextStr.size(), '0');
-        
-        // Combine into header
-        std::string header = countStr + prevStr + nextStr;
-        
-        // Update buffer with header
-        if (buffer.size() >= header.size()) {
-            buffer.replace(0, header.size(), header);
-        } else {
-            buffer = header + buffer.substr(header.size());
+        BlockHeader hdr = {};
+        hdr.blockType = blockType;
+        hdr.recordCount = static_cast<uint32_t>(recordCount);
+        hdr.freeSpace = static_cast<uint32_t>(freeSpace);
+        hdr.prevRBN = prevBlockRBN;
+        hdr.nextRBN = nextBlockRBN;
+        blockHeaderToLittleEndian(hdr);
+
+        if (buffer.size() < sizeof(BlockHeader)) {
+            buffer.resize(sizeof(BlockHeader));
         }
+        std::memcpy(&buffer[0], &hdr, sizeof(BlockHeader));
     }
 
 public:
@@ -87,10 +130,14 @@ public:
      * @param block_size Size of a block in bytes
      * @param rec_size_bytes Number of bytes for record size
      * @param is_binary Flag for binary or ASCII format
+     * @param record_format Encoding of record payloads
      */
-    BlockBuffer(int block_size = 512, int rec_size_bytes = 4, bool is_binary = false)
+    BlockBuffer(int block_size = 512, int rec_size_bytes = 4, bool is_binary = false,
+                RecordFormat record_format = RECORD_FORMAT_CSV)
         : blockSize(block_size), prevBlockRBN(-1), nextBlockRBN(-1), recordCount(0),
-          headerSize(12), recordSizeBytes(rec_size_bytes), isBinary(is_binary) {
+          blockType(BLOCK_TYPE_DATA), freeSpace(block_size - static_cast<int>(sizeof(BlockHeader))),
+          headerSize(sizeof(BlockHeader)), recordSizeBytes(rec_size_bytes), isBinary(is_binary),
+          recordFormat(record_format), blockMap(nullptr), dictionary(nullptr) {
         buffer.resize(blockSize, ' ');
         createHeader();
     }
@@ -103,25 +150,52 @@ public:
      * @return true if successful, false otherwise
      */
     bool read(std::ifstream& file, int rbn, int header_size) {
-        if (!file.is_open() || rbn < 0) {
+        if (!readRaw(file, rbn, header_size)) {
             return false;
         }
         
-        // Calculate file position
-        std::streampos pos = header_size + static_cast<std::streampos>(rbn) * blockSize;
-        file.seekg(pos);
-        
-        // Read block into buffer
-        buffer.resize(blockSize);
-        file.read(&buffer[0], blockSize);
+        // Unpack records
+        unpackRecords();
         
-        if (!file) {
+        return true;
+    }
+    
+    /**
+     * @brief Read a block's bytes and header without unpacking records
+     *
+     * Use with BlockView to access records in place.
+     * @param file Input file stream
+     * @param rbn Relative Block Number
+     * @param header_size Size of the file header
+     * @return true if successful, false otherwise
+     */
+    bool readRaw(std::ifstream& file, int rbn, int header_size) {
+        if (!file.is_open() || rbn < 0) {
             return false;
         }
         
-        // Parse the header and unpack records
+        if (blockMap) {
+            // Compressed file: decompress the block's extent into the buffer
+            if (!blockMap->read(file, rbn, buffer, blockSize)) {
+                return false;
+            }
+        } else {
+            // Calculate file position
+            std::streampos pos = header_size + static_cast<std::streampos>(rbn) * blockSize;
+            file.seekg(pos);
+            
+            // Read block into buffer
+            buffer.resize(blockSize);
+            file.read(&buffer[0], blockSize);
+            
+            if (!file) {
+                return false;
+            }
+        }
+        
+        // Parse the header
+        records.clear();
         parseHeader();
-        unpackRecords();
         
         return true;
     }
@@ -141,6 +215,10 @@ public:
         // Pack records into buffer
         packRecords();
         
+        if (blockMap) {
+            return blockMap->write(file, rbn, buffer);
+        }
+        
         // Calculate file position
         std::streampos pos = header_size + static_cast<std::streampos>(rbn) * blockSize;
         file.seekp(pos);
@@ -155,34 +233,39 @@ public:
      * @brief Pack records into the buffer
      */
     void packRecords() {
-        // Update record count
-        recordCount = records.size();
-        
-        // Create header
-        createHeader();
-        
         // Start with a fresh buffer (after header)
-        buffer.resize(blockSize, ' ');
-        buffer.replace(0, headerSize, buffer.substr(0, headerSize));
+        buffer.assign(blockSize, ' ');
         
         // Position in buffer after header
         int pos = headerSize;
+        int packed = 0;
         
         // Pack each record
         for (const auto& record : records) {
-            RecordBuffer recBuffer(recordSizeBytes, isBinary);
-            recBuffer.pack(record);
+            RecordBuffer recBuffer(recordSizeBytes, isBinary, recordFormat, dictionary);
+            if (!recBuffer.pack(record)) {
+                continue;
+            }
             std::string recStr = recBuffer.getBuffer();
             
             // Check if record fits in the block
-            if (pos + recStr.size() > blockSize) {
+            if (pos + static_cast<int>(recStr.size()) > blockSize) {
                 break;
             }
             
             // Add record to buffer
             buffer.replace(pos, recStr.size(), recStr);
             pos += recStr.size();
+            packed++;
+        }
+        
+        // Update record count, free space and header
+        recordCount = packed;
+        freeSpace = blockSize - pos;
+        if (!records.empty()) {
+            blockType = BLOCK_TYPE_DATA;
         }
+        createHeader();
     }
     
     /**
@@ -200,7 +283,7 @@ public:
         
         // Unpack each record
         for (int i = 0; i < recordCount; i++) {
-            RecordBuffer recBuffer(recordSizeBytes, isBinary);
+            RecordBuffer recBuffer(recordSizeBytes, isBinary, recordFormat, dictionary);
             
             // Extract record length
             int recLen = 0;
@@ -233,14 +316,16 @@ public:
      */
     bool addRecord(const ZipCodeRecord& record) {
         // Create a temporary record buffer to check size
-        RecordBuffer recBuffer(recordSizeBytes, isBinary);
-        recBuffer.pack(record);
+        RecordBuffer recBuffer(recordSizeBytes, isBinary, recordFormat, dictionary);
+        if (!recBuffer.pack(record)) {
+            return false;
+        }
         int recSize = recBuffer.getLength();
         
         // Calculate current used space in the block
         int usedSpace = headerSize;
         for (const auto& rec : records) {
-            RecordBuffer tempBuf(recordSizeBytes, isBinary);
+            RecordBuffer tempBuf(recordSizeBytes, isBinary, recordFormat, dictionary);
             tempBuf.pack(rec);
             usedSpace += tempBuf.getLength();
         }
@@ -321,13 +406,13 @@ public:
         // Calculate total size after merge
         int totalSize = headerSize;
         for (const auto& rec : records) {
-            RecordBuffer recBuffer(recordSizeBytes, isBinary);
+            RecordBuffer recBuffer(recordSizeBytes, isBinary, recordFormat, dictionary);
             recBuffer.pack(rec);
             totalSize += recBuffer.getLength();
         }
         
         for (const auto& rec : other.getRecords()) {
-            RecordBuffer recBuffer(recordSizeBytes, isBinary);
+            RecordBuffer recBuffer(recordSizeBytes, isBinary, recordFormat, dictionary);
             recBuffer.pack(rec);
             totalSize += recBuffer.getLength();
         }
@@ -404,6 +489,8 @@ public:
     void convertToAvailBlock() {
         records.clear();
         recordCount = 0;
+        blockType = BLOCK_TYPE_AVAIL;
+        freeSpace = blockSize - headerSize;
         
         // Clear buffer except for header
         buffer.replace(headerSize, blockSize - headerSize, blockSize - headerSize, ' ');
@@ -417,7 +504,7 @@ public:
      * @return true if this is an availability list block, false otherwise
      */
     bool isAvailBlock() const {
-        return recordCount == 0;
+        return blockType == BLOCK_TYPE_AVAIL;
     }
     
     /**
@@ -462,6 +549,48 @@ public:
      */
     int getRecordCount() const { return recordCount; }
     
+    /**
+     * @brief Get the block type tag
+     * @return One of the BlockType values
+     */
+    uint8_t getBlockType() const { return blockType; }
+    
+    /**
+     * @brief Get the free space recorded in the block header
+     * @return The free space in bytes as of the last pack or read
+     */
+    int getFreeSpace() const { return freeSpace; }
+    
+    /**
+     * @brief Get the raw block bytes
+     * @return The buffer holding the packed block
+     */
+    const std::string& getBuffer() const { return buffer; }
+    
+    /**
+     * @brief Get the number of bytes for record size
+     * @return The number of bytes for record size
+     */
+    int getRecordSizeBytes() const { return recordSizeBytes; }
+    
+    /**
+     * @brief Check if record sizes are stored in binary
+     * @return true for binary size format, false for ASCII
+     */
+    bool isBinaryFormat() const { return isBinary; }
+    
+    /**
+     * @brief Get the encoding of record payloads
+     * @return The record format
+     */
+    RecordFormat getRecordFormat() const { return recordFormat; }
+    
+    /**
+     * @brief Get the string dictionary used by dictionary-encoded records
+     * @return The dictionary, or nullptr
+     */
+    const RecordDictionary* getDictionary() const { return dictionary; }
+    
     /**
      * @brief Get the records in the block
      * @return The records
@@ -480,6 +609,18 @@ public:
      */
     void setNextBlockRBN(int rbn) { nextBlockRBN = rbn; }
     
+    /**
+     * @brief Route reads and writes through a compressed extent map
+     * @param map The block map, or nullptr for fixed-size uncompressed blocks
+     */
+    void setBlockMap(BlockMap* map) { blockMap = map; }
+    
+    /**
+     * @brief Set the string dictionary for dictionary-encoded records
+     * @param dict The file's dictionary, or nullptr for other record formats
+     */
+    void setDictionary(RecordDictionary* dict) { dictionary = dict; }
+    
     /**
      * @brief Set the block size
      * @param size The block size
@@ -493,7 +634,7 @@ public:
     int getAvailableSpace() const {
         int usedSpace = headerSize;
         for (const auto& rec : records) {
-            RecordBuffer recBuffer(recordSizeBytes, isBinary);
+            RecordBuffer recBuffer(recordSizeBytes, isBinary, recordFormat, dictionary);
             recBuffer.pack(rec);
             usedSpace += recBuffer.getLength();
         }
@@ -507,10 +648,12 @@ public:
     double getUsagePercentage() const {
         int usedSpace = headerSize;
         for (const auto& rec : records) {
-            RecordBuffer recBuffer(recordSizeBytes, isBinary);
+            RecordBuffer recBuffer(recordSizeBytes, isBinary, recordFormat, dictionary);
             recBuffer.pack(rec);
             usedSpace += recBuffer.getLength();
         }
         return 100.0 * usedSpace / blockSize;
     }
-};
\ No newline at end of file
+};
+
+#endif // BLOCK_BUFFER_H
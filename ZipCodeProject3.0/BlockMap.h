@@ -0,0 +1,208 @@
+/**
+ * @file BlockMap.h
+ * @brief Definition of the BlockMap class mapping logical blocks to compressed extents
+ */
+
+#ifndef BLOCK_MAP_H
+#define BLOCK_MAP_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include "BlockCodec.h"
+
+/**
+ * @struct BlockExtent
+ * @brief Location of one compressed block in the data file
+ */
+struct BlockExtent {
+    uint64_t offset;        ///< Byte offset of the extent in the data file
+    uint32_t length;        ///< Number of stored bytes
+    uint32_t capacity;      ///< Bytes reserved at offset (reused when a rewrite fits)
+    uint8_t codec;          ///< Codec used for this extent (CODEC_NONE if incompressible)
+    uint8_t reserved[7];    ///< Padding, always zero
+};
+
+/**
+ * @class BlockMap
+ * @brief Maps logical RBNs to variable-size physical extents for compressed files
+ *
+ * Rewritten blocks stay in place when they fit in their extent and are
+ * appended to the end of the data file otherwise. The map is kept in
+ * memory and persisted to a sidecar file by save().
+ */
+class BlockMap {
+private:
+    std::vector<BlockExtent> extents;   ///< Extent for each RBN (length 0 = never written)
+    uint64_t dataEnd;                   ///< First free byte at the end of the data file
+    BlockCodecType codec;               ///< Codec for new extents
+    std::string scratch;                ///< Reusable compression/read buffer
+    bool dirty;                         ///< Whether the map changed since load/save
+
+public:
+    /**
+     * @brief Constructor
+     * @param block_codec Codec for new extents
+     * @param data_start Offset of the first extent (the file header size)
+     */
+    BlockMap(BlockCodecType block_codec = CODEC_LZ, uint64_t data_start = 0)
+        : dataEnd(data_start), codec(block_codec), dirty(false) {}
+
+    /**
+     * @brief Reset to an empty map
+     * @param block_codec Codec for new extents
+     * @param data_start Offset of the first extent (the file header size)
+     */
+    void reset(BlockCodecType block_codec, uint64_t data_start) {
+        extents.clear();
+        dataEnd = data_start;
+        codec = block_codec;
+        dirty = true;
+    }
+
+    /**
+     * @brief Read and decompress a block
+     * @param file Input file stream
+     * @param rbn Relative Block Number
+     * @param block Output buffer, resized to blockSize
+     * @param blockSize Size of an uncompressed block
+     * @return true if successful, false otherwise
+     */
+    bool read(std::ifstream& file, int rbn, std::string& block, int blockSize) {
+        if (rbn < 0 || rbn >= static_cast<int>(extents.size()) || extents[rbn].length == 0) {
+            return false;
+        }
+
+        const BlockExtent& extent = extents[rbn];
+        scratch.resize(extent.length);
+        file.seekg(static_cast<std::streamoff>(extent.offset));
+        file.read(&scratch[0], extent.length);
+        if (!file) {
+            return false;
+        }
+
+        block.resize(blockSize);
+        return BlockCodec::decompress(static_cast<BlockCodecType>(extent.codec), scratch.data(),
+                                      extent.length, &block[0], blockSize);
+    }
+
+    /**
+     * @brief Compress and write a block
+     * @param file Output file stream
+     * @param rbn Relative Block Number
+     * @param block The uncompressed block
+     * @return true if successful, false otherwise
+     */
+    bool write(std::ofstream& file, int rbn, const std::string& block) {
+        if (rbn < 0) {
+            return false;
+        }
+
+        // Fall back to storing the block raw if it does not compress
+        BlockCodecType used = codec;
+        if (!BlockCodec::compress(codec, block.data(), block.size(), scratch) ||
+            scratch.size() >= block.size()) {
+            used = CODEC_NONE;
+            scratch.assign(block);
+        }
+
+        if (rbn >= static_cast<int>(extents.size())) {
+            extents.resize(rbn + 1, BlockExtent());
+        }
+
+        BlockExtent& extent = extents[rbn];
+        if (extent.capacity < scratch.size()) {
+            extent.offset = dataEnd;
+            extent.capacity = scratch.size();
+            dataEnd += scratch.size();
+        }
+        extent.length = scratch.size();
+        extent.codec = used;
+        dirty = true;
+
+        file.seekp(static_cast<std::streamoff>(extent.offset));
+        file.write(scratch.data(), scratch.size());
+        return file.good();
+    }
+
+    /**
+     * @brief Load the map from its sidecar file
+     * @param fileName Name of the map file
+     * @return true if successful, false otherwise
+     */
+    bool load(const std::string& fileName) {
+        std::ifstream file(fileName, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        uint64_t count = 0;
+        uint8_t codecByte = 0;
+        file.read(reinterpret_cast<char*>(&count), sizeof(count));
+        file.read(reinterpret_cast<char*>(&dataEnd), sizeof(dataEnd));
+        file.read(reinterpret_cast<char*>(&codecByte), sizeof(codecByte));
+        if (!file) {
+            return false;
+        }
+
+        codec = static_cast<BlockCodecType>(codecByte);
+        extents.resize(count);
+        file.read(reinterpret_cast<char*>(extents.data()), count * sizeof(BlockExtent));
+        dirty = false;
+        return file.good() || count == 0;
+    }
+
+    /**
+     * @brief Save the map to its sidecar file
+     * @param fileName Name of the map file
+     * @return true if successful, false otherwise
+     */
+    bool save(const std::string& fileName) {
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        uint64_t count = extents.size();
+        uint8_t codecByte = codec;
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char*>(&dataEnd), sizeof(dataEnd));
+        file.write(reinterpret_cast<const char*>(&codecByte), sizeof(codecByte));
+        file.write(reinterpret_cast<const char*>(extents.data()), count * sizeof(BlockExtent));
+        dirty = false;
+        return file.good();
+    }
+
+    /**
+     * @brief Check if the map has unsaved changes
+     * @return true if save() is needed
+     */
+    bool isDirty() const { return dirty; }
+
+    /**
+     * @brief Get the number of stored (compressed) bytes across all extents
+     * @return The total stored size in bytes
+     */
+    uint64_t getStoredBytes() const {
+        uint64_t total = 0;
+        for (const auto& extent : extents) {
+            total += extent.length;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Get the number of mapped blocks
+     * @return The number of extents
+     */
+    int getBlockCount() const { return extents.size(); }
+
+    /**
+     * @brief Get the codec used for new extents
+     * @return The codec
+     */
+    BlockCodecType getCodec() const { return codec; }
+};
+
+#endif // BLOCK_MAP_H
@@ -4,75 +4,73 @@
  */
 
 #include "Buffer.h"
+#include "CSVTokenizer.h"
+#include "MappedFile.h"
 
 using namespace std;
 
 bool Buffer::readLengthIndicatedFile(const string& filename, vector<ZipCodeRecord>& records) {
-    ifstream file(filename);
-    if (!file.is_open()) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
         cerr << "Error: Could not open the length-indicated file " << filename << endl;
         return false;
     }
 
+    CSVLineReader reader(file.data(), file.size());
+    CSVTokenizer tokenizer;
+    string_view line;
+
     int linesToSkip = 15; // Skip the 15 header lines: 8 fixed + 6 fields + 1 primary key line
-    string dummy;
     for (int i = 0; i < linesToSkip; ++i) {
-        getline(file, dummy);
+        reader.nextLine(line);
     }
 
-    string line;
-    while (getline(file, line)) {
+    while (reader.nextLine(line)) {
         if (line.size() < 3) {  // Check for valid line format
             cerr << "Error: Malformed record: " << line << endl;
             continue;
         }
-        
-        string lengthStr = line.substr(0, 2); // Extract first two characters as length
-        int recordLength = stoi(lengthStr); // Convert to length value integer
-
-        string recordData = line.substr(3); // Extract the actual CSV record after the length is processed
-
-        stringstream ss(recordData);
-        ZipCodeRecord record;
-        string zip, lat, lon;
-        vector<string> values;
-        string token;
 
-        while (getline(ss, token, ',')) {
-            values.push_back(token);
-        }
+        string_view recordData = line.substr(3); // The actual CSV record after the 2-digit length and comma
 
-        if (values.size() != 6) {
+        if (tokenizer.split(recordData) != 6) {
             cerr << "Error: Incorrect number of fields in length-indicated record: " << recordData << endl;
             continue;
         }
 
         // Fill ZipCodeRecord fields
-        zip = values[0];
-        record.place_name = values[1];
-        record.state = values[2];
-        record.county = values[3];
-        lat = values[4];
-        lon = values[5];
-
-        try {
-            record.zip_code = stoi(zip);
-            record.lat = stod(lat);
-            record.lon = stod(lon);
-        } catch (const exception& e) { // Error catching
-            cerr << "Error parsing numeric values in record: " << recordData << " - " << e.what() << endl;
+        ZipCodeRecord record;
+        if (!CSVTokenizer::parseInt(tokenizer[0], record.zip_code) ||
+            !CSVTokenizer::parseDouble(tokenizer[4], record.lat) ||
+            !CSVTokenizer::parseDouble(tokenizer[5], record.lon)) { // Error catching
+            cerr << "Error parsing numeric values in record: " << recordData << endl;
             continue;
         }
+        record.place_name = strings.intern(tokenizer[1]);
+        record.state = strings.intern(tokenizer[2]);
+        record.county = strings.intern(tokenizer[3]);
 
         records.push_back(record);
     }
 
-    file.close();
     return true;
 }
 
 void Buffer::processRecords(const vector<ZipCodeRecord>& records, map<string, vector<ZipCodeRecord>>& state_map) {
+    // Count each state first so every vector is allocated exactly once
+    unordered_map<string_view, size_t> counts;
+    for (const auto& record : records) {
+        counts[record.state]++;
+    }
+
+    unordered_map<string_view, vector<ZipCodeRecord>*> groups;
+    for (const auto& entry : counts) {
+        vector<ZipCodeRecord>& group = state_map[string(entry.first)];
+        group.reserve(group.size() + entry.second);
+        groups[entry.first] = &group;
+    }
+
     for (const auto& record : records) {
-        state_map[record.state].push_back(record);
+        groups[record.state]->push_back(record);
     }
 }
@@ -0,0 +1,380 @@
+/**
+ * @file CSVScanner.h
+ * @brief Definition of the CSVStructuralIndexer and CSVBulkReader classes for vectorized CSV ingest
+ *
+ * The indexer classifies 64 bytes at a time into bitmaps of delimiters,
+ * newlines and quotes (AVX2 or SSE2 when the compiler targets them, scalar
+ * otherwise), masks out everything inside quoted fields, and flattens the
+ * remaining bits into a list of structural positions. The bulk reader walks
+ * that list to hand out records without looking at the bytes again.
+ *
+ * Build with -mavx2 (or -march=native) to enable the AVX2 path; SSE2 is
+ * always available on x86-64.
+ */
+
+#ifndef CSV_SCANNER_H
+#define CSV_SCANNER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <istream>
+#include <cstdint>
+#include <cstring>
+#include "CSVTokenizer.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CSV_SCANNER_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CSV_SCANNER_SSE2 1
+#endif
+
+/**
+ * @class CSVStructuralIndexer
+ * @brief Finds delimiter and newline positions outside quotes, 64 bytes per step
+ */
+class CSVStructuralIndexer {
+private:
+    char delimiter;     ///< Field separator
+    bool inQuotes;      ///< Whether the previous block ended inside a quoted field
+    bool sawQuotes;     ///< Whether the last index() call saw any quote
+
+    /**
+     * @brief Bitmaps for one 64-byte block (bit i = byte i)
+     */
+    struct BlockMasks {
+        uint64_t delimiters;    ///< Delimiter bytes
+        uint64_t newlines;      ///< '\n' bytes
+        uint64_t quotes;        ///< '"' bytes
+    };
+
+    /**
+     * @brief Classify the bytes of one 64-byte block
+     * @param p Start of the block (64 readable bytes)
+     * @param masks Output parameter for the bitmaps
+     */
+    void classify(const char* p, BlockMasks& masks) const {
+#if defined(CSV_SCANNER_AVX2)
+        const __m256i delim = _mm256_set1_epi8(delimiter);
+        const __m256i newline = _mm256_set1_epi8('\n');
+        const __m256i quote = _mm256_set1_epi8('"');
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+        auto mask = [](__m256i a, __m256i b, __m256i c) {
+            uint32_t l = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, c)));
+            uint32_t h = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(b, c)));
+            return static_cast<uint64_t>(l) | (static_cast<uint64_t>(h) << 32);
+        };
+        masks.delimiters = mask(lo, hi, delim);
+        masks.newlines = mask(lo, hi, newline);
+        masks.quotes = mask(lo, hi, quote);
+#elif defined(CSV_SCANNER_SSE2)
+        const __m128i delim = _mm_set1_epi8(delimiter);
+        const __m128i newline = _mm_set1_epi8('\n');
+        const __m128i quote = _mm_set1_epi8('"');
+        masks.delimiters = masks.newlines = masks.quotes = 0;
+        for (int i = 0; i < 4; i++) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+            int shift = 16 * i;
+            masks.delimiters |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, delim))) << shift;
+            masks.newlines |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline))) << shift;
+            masks.quotes |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote))) << shift;
+        }
+#else
+        masks.delimiters = masks.newlines = masks.quotes = 0;
+        for (int i = 0; i < 64; i++) {
+            uint64_t bit = static_cast<uint64_t>(1) << i;
+            if (p[i] == delimiter) masks.delimiters |= bit;
+            else if (p[i] == '\n') masks.newlines |= bit;
+            else if (p[i] == '"') masks.quotes |= bit;
+        }
+#endif
+    }
+
+    /**
+     * @brief Prefix XOR: bit i is set if an odd number of bits at or below i are set
+     * @param x The input bits
+     * @return The running parity
+     */
+    static uint64_t prefixXor(uint64_t x) {
+        x ^= x << 1;
+        x ^= x << 2;
+        x ^= x << 4;
+        x ^= x << 8;
+        x ^= x << 16;
+        x ^= x << 32;
+        return x;
+    }
+
+    /**
+     * @brief Get the structural bits of one block and update the quote state
+     * @param p Start of the block (64 readable bytes)
+     * @return Bitmap of delimiters and newlines outside quotes
+     */
+    uint64_t structurals(const char* p) {
+        BlockMasks masks;
+        classify(p, masks);
+
+        // Bytes between an opening and closing quote; "" toggles twice and stays quoted
+        if (masks.quotes == 0 && !inQuotes) {
+            return masks.delimiters | masks.newlines;
+        }
+        sawQuotes = true;
+        uint64_t quoted = prefixXor(masks.quotes) ^ (inQuotes ? ~static_cast<uint64_t>(0) : 0);
+        inQuotes = (quoted >> 63) != 0;
+        return (masks.delimiters | masks.newlines) & ~quoted;
+    }
+
+public:
+    /**
+     * @brief Constructor
+     * @param delim Field separator
+     */
+    explicit CSVStructuralIndexer(char delim = ',') : delimiter(delim), inQuotes(false), sawQuotes(false) {}
+
+    /**
+     * @brief Reset the quote state (call before indexing from the start of a line)
+     */
+    void reset() { inQuotes = false; }
+
+    /**
+     * @brief Check whether the last index() call saw any quote character
+     * @return true if quoted fields may need unescaping
+     */
+    bool hasQuotes() const { return sawQuotes; }
+
+    /**
+     * @brief Index a byte range
+     * @param data Start of the bytes
+     * @param len Number of bytes
+     * @param positions Output parameter for the offsets of delimiters and newlines outside
+     *        quotes; only grown, so entries past the returned count are stale
+     * @return The number of positions
+     */
+    size_t index(const char* data, size_t len, std::vector<uint32_t>& positions) {
+        if (positions.size() < len + 64) {
+            positions.resize(len + 64);
+        }
+        uint32_t* out = positions.data();
+        size_t count = 0;
+        sawQuotes = false;
+
+        size_t base = 0;
+        for (; base + 64 <= len; base += 64) {
+            uint64_t bits = structurals(data + base);
+            while (bits) {
+                out[count++] = static_cast<uint32_t>(base + __builtin_ctzll(bits));
+                bits &= bits - 1;
+            }
+        }
+
+        // Pad the tail with a byte that is never structural
+        if (base < len) {
+            char tail[64];
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, data + base, len - base);
+            uint64_t bits = structurals(tail);
+            while (bits) {
+                out[count++] = static_cast<uint32_t>(base + __builtin_ctzll(bits));
+                bits &= bits - 1;
+            }
+        }
+
+        return count;
+    }
+};
+
+/**
+ * @class CSVBulkReader
+ * @brief Reads CSV records from a stream, or from bytes already in memory, using the structural index
+ *
+ * Bytes are indexed one window at a time and records are returned as views
+ * into the window; the field views stay valid until the next call to
+ * nextRecord(). In memory mode (e.g. over a MappedFile) nothing is copied.
+ */
+class CSVBulkReader {
+private:
+    std::istream* input;                    ///< Stream being read (nullptr when reading from memory)
+    std::string buffer;                     ///< Read buffer in stream mode
+    const char* data;                       ///< Bytes being read (buffer or caller's memory)
+    size_t dataLength;                      ///< Number of valid bytes in data
+    size_t windowSize;                      ///< Bytes indexed per window in memory mode
+    size_t windowStart;                     ///< Offset in data of the indexed window
+    size_t windowEnd;                       ///< End offset in data of the indexed window
+    size_t begin;                           ///< Offset in data of the next record
+    bool eof;                               ///< Whether the stream is exhausted
+    char delimiter;                         ///< Field separator
+    CSVStructuralIndexer indexer;           ///< Vectorized structural scanner
+    std::vector<uint32_t> positions;        ///< Structural positions relative to windowStart
+    size_t positionCount;                   ///< Number of valid entries in positions
+    size_t next;                            ///< Next unconsumed entry of positions
+    std::vector<std::string_view> fields;   ///< Fields of the current record
+    CSVTokenizer quotedFields;              ///< Unescapes records that contain quoted fields
+
+    /**
+     * @brief Index the window [windowStart, windowEnd)
+     */
+    void indexWindow() {
+        // Windows start at a record boundary, so they start outside quotes
+        indexer.reset();
+        positionCount = indexer.index(data + windowStart, windowEnd - windowStart, positions);
+        next = 0;
+    }
+
+    /**
+     * @brief Move the window forward to start at the next record
+     * @return true if more bytes were indexed, false at end of input
+     */
+    bool advance() {
+        if (!input) {
+            if (windowEnd >= dataLength) {
+                return false;
+            }
+            // Grow the window until it extends past the record that did not fit
+            size_t stop = begin + windowSize;
+            while (stop <= windowEnd) {
+                windowSize *= 2;
+                stop = begin + windowSize;
+            }
+            windowStart = begin;
+            windowEnd = stop < dataLength ? stop : dataLength;
+            indexWindow();
+            return true;
+        }
+
+        if (eof) {
+            return false;
+        }
+        if (begin > 0) {
+            std::memmove(&buffer[0], buffer.data() + begin, dataLength - begin);
+            dataLength -= begin;
+            begin = 0;
+        }
+        if (dataLength == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        data = buffer.data();
+
+        input->read(&buffer[dataLength], buffer.size() - dataLength);
+        std::streamsize n = input->gcount();
+        if (n <= 0) {
+            // Re-index the moved remainder so a last line without a newline can be finished
+            eof = true;
+            if (dataLength == 0) {
+                return false;
+            }
+        } else {
+            dataLength += n;
+        }
+        windowStart = 0;
+        windowEnd = dataLength;
+        indexWindow();
+        return true;
+    }
+
+    /**
+     * @brief Complete the current record at a line end
+     * @param fieldStart Offset of the last field
+     * @param lineEnd Offset of the newline, or the end of input
+     * @param line Output parameter for the whole line
+     */
+    void finishRecord(size_t fieldStart, size_t lineEnd, std::string_view& line) {
+        if (lineEnd > begin && data[lineEnd - 1] == '\r') {
+            lineEnd--;
+        }
+        fields.emplace_back(data + fieldStart, lineEnd > fieldStart ? lineEnd - fieldStart : 0);
+        line = std::string_view(data + begin, lineEnd - begin);
+
+        // Quoted fields need unescaping; the tokenizer handles those rare lines
+        if (indexer.hasQuotes() && std::memchr(line.data(), '"', line.size())) {
+            quotedFields.split(line);
+            fields.clear();
+            for (int f = 0; f < quotedFields.size(); f++) {
+                fields.push_back(quotedFields[f]);
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Constructor for reading a stream
+     * @param in The stream to read (should be opened in binary mode)
+     * @param bufferSize Initial read buffer size in bytes
+     * @param delim Field separator
+     */
+    explicit CSVBulkReader(std::istream& in, size_t bufferSize = 1 << 16, char delim = ',')
+        : input(&in), buffer(bufferSize > 0 ? bufferSize : 1, '\0'), data(buffer.data()), dataLength(0),
+          windowSize(buffer.size()), windowStart(0), windowEnd(0), begin(0), eof(false),
+          delimiter(delim), indexer(delim), positionCount(0), next(0), quotedFields(delim) {
+        fields.reserve(16);
+    }
+
+    /**
+     * @brief Constructor for reading bytes already in memory (e.g. a MappedFile)
+     * @param bytes Start of the bytes (must outlive the reader)
+     * @param length Number of bytes
+     * @param window Bytes indexed per step (kept small so the index stays in cache)
+     * @param delim Field separator
+     */
+    CSVBulkReader(const char* bytes, size_t length, size_t window = 1 << 16, char delim = ',')
+        : input(nullptr), data(bytes), dataLength(length), windowSize(window > 0 ? window : 1),
+          windowStart(0), windowEnd(0), begin(0), eof(true), delimiter(delim), indexer(delim),
+          positionCount(0), next(0), quotedFields(delim) {
+        fields.reserve(16);
+    }
+
+    /**
+     * @brief Read the next record
+     * @param line Output parameter for the whole line without its terminator
+     * @return true if a record was read, false at end of input
+     */
+    bool nextRecord(std::string_view& line) {
+        for (;;) {
+            fields.clear();
+            size_t fieldStart = begin;
+            for (size_t i = next; i < positionCount; i++) {
+                size_t p = windowStart + positions[i];
+                if (data[p] == delimiter) {
+                    fields.emplace_back(data + fieldStart, p - fieldStart);
+                    fieldStart = p + 1;
+                    continue;
+                }
+
+                // Newline: the record is complete
+                finishRecord(fieldStart, p, line);
+                begin = p + 1;
+                next = i + 1;
+                return true;
+            }
+
+            if (!advance()) {
+                if (begin >= dataLength) {
+                    return false;
+                }
+                // Last line without a newline; the window already covers it
+                finishRecord(fieldStart, dataLength, line);
+                begin = dataLength;
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Get the number of fields in the current record
+     * @return The field count
+     */
+    int size() const { return static_cast<int>(fields.size()); }
+
+    /**
+     * @brief Get a field of the current record
+     * @param index Zero-based field index
+     * @return The field, or an empty view if it does not exist
+     */
+    std::string_view operator[](int index) const {
+        return index >= 0 && index < static_cast<int>(fields.size()) ? fields[index] : std::string_view();
+    }
+};
+
+#endif // CSV_SCANNER_H
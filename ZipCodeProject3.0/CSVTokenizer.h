@@ -0,0 +1,276 @@
+/**
+ * @file CSVTokenizer.h
+ * @brief Definition of the CSVLineReader and CSVTokenizer classes for allocation-free CSV parsing
+ *
+ * CSVLineReader hands out lines as views into a reusable read buffer and
+ * CSVTokenizer splits a line into field views, so once the buffers have
+ * grown to fit the longest line no further allocation happens per record.
+ */
+
+#ifndef CSV_TOKENIZER_H
+#define CSV_TOKENIZER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <istream>
+#include <charconv>
+#include <cstring>
+
+/**
+ * @class CSVLineReader
+ * @brief Reads lines from a stream in large chunks, or from bytes already in memory, without per-line allocation
+ */
+class CSVLineReader {
+private:
+    std::istream* input;      ///< Stream being read (nullptr when reading from memory)
+    std::string buffer;       ///< Read buffer (grows only for lines longer than its size)
+    const char* data;         ///< Bytes being split (buffer or caller's memory)
+    size_t begin;             ///< Start of unconsumed bytes in data
+    size_t end;               ///< End of valid bytes in data
+    long bufferOffset;        ///< Stream offset of data[0]
+    long lineOffset;          ///< Stream offset of the last line returned
+    bool eof;                 ///< Whether the input is exhausted
+
+    /**
+     * @brief Move unconsumed bytes to the front of the buffer and read more
+     * @return true if any bytes were read, false at end of input
+     */
+    bool refill() {
+        if (eof) {
+            return false;
+        }
+
+        if (begin > 0) {
+            std::memmove(&buffer[0], buffer.data() + begin, end - begin);
+            bufferOffset += begin;
+            end -= begin;
+            begin = 0;
+        }
+        if (end == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        data = buffer.data();
+
+        input->read(&buffer[end], buffer.size() - end);
+        std::streamsize n = input->gcount();
+        if (n <= 0) {
+            eof = true;
+            return false;
+        }
+        end += n;
+        return true;
+    }
+
+public:
+    /**
+     * @brief Constructor for reading a stream
+     * @param in The stream to read (should be opened in binary mode for exact offsets)
+     * @param bufferSize Initial read buffer size in bytes
+     */
+    explicit CSVLineReader(std::istream& in, size_t bufferSize = 1 << 16)
+        : input(&in), buffer(bufferSize > 0 ? bufferSize : 1, '\0'), data(buffer.data()), begin(0),
+          end(0), bufferOffset(0), lineOffset(0), eof(false) {}
+
+    /**
+     * @brief Constructor for reading bytes already in memory (e.g. a MappedFile)
+     *
+     * Lines are views into the caller's bytes, which must outlive the reader.
+     * @param bytes Start of the bytes
+     * @param length Number of bytes
+     */
+    CSVLineReader(const char* bytes, size_t length)
+        : input(nullptr), data(bytes), begin(0), end(length), bufferOffset(0), lineOffset(0),
+          eof(true) {}
+
+    /**
+     * @brief Get the next line without its terminator ("\n" or "\r\n")
+     *
+     * When reading a stream, the view is valid until the next call.
+     * @param line Output parameter for the line
+     * @return true if a line was read, false at end of input
+     */
+    bool nextLine(std::string_view& line) {
+        size_t scanFrom = begin;
+        for (;;) {
+            const char* nl = end > scanFrom ? static_cast<const char*>(
+                std::memchr(data + scanFrom, '\n', end - scanFrom)) : nullptr;
+            if (nl) {
+                size_t pos = nl - data;
+                line = std::string_view(data + begin, pos - begin);
+                lineOffset = bufferOffset + begin;
+                begin = pos + 1;
+                break;
+            }
+
+            size_t scanned = end - begin;
+            if (!refill()) {
+                if (begin == end) {
+                    return false;
+                }
+                // Last line without a terminator
+                line = std::string_view(data + begin, end - begin);
+                lineOffset = bufferOffset + begin;
+                begin = end;
+                break;
+            }
+            scanFrom = begin + scanned;
+        }
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Get the input offset of the line last returned by nextLine()
+     * @return The byte offset of the start of the line
+     */
+    long getLineOffset() const { return lineOffset; }
+
+    /**
+     * @brief Get the input offset of the first byte not yet returned
+     * @return The byte offset just past the last line returned
+     */
+    long getOffset() const { return bufferOffset + begin; }
+};
+
+/**
+ * @class CSVTokenizer
+ * @brief Splits a CSV line into field views
+ *
+ * Quoted fields may contain delimiters and doubled quotes (""); their
+ * unescaped text is written to a scratch buffer owned by the tokenizer.
+ * Field views stay valid until the next split().
+ */
+class CSVTokenizer {
+private:
+    std::vector<std::string_view> fields;   ///< Fields of the current line
+    std::string scratch;                    ///< Unescaped text of quoted fields
+    char delimiter;                         ///< Field separator
+
+public:
+    /**
+     * @brief Constructor
+     * @param delim Field separator
+     */
+    explicit CSVTokenizer(char delim = ',') : delimiter(delim) {
+        fields.reserve(16);
+    }
+
+    /**
+     * @brief Split a line into fields
+     * @param line The line to split (must outlive the field views)
+     * @return The number of fields
+     */
+    int split(std::string_view line) {
+        fields.clear();
+        // Unescaped text is never longer than the line, so scratch never reallocates mid-line
+        if (scratch.size() < line.size()) {
+            scratch.resize(line.size());
+        }
+        size_t out = 0;
+
+        size_t pos = 0;
+        for (;;) {
+            if (pos < line.size() && line[pos] == '"') {
+                size_t start = out;
+                pos++;
+                while (pos < line.size()) {
+                    if (line[pos] == '"') {
+                        if (pos + 1 < line.size() && line[pos + 1] == '"') {
+                            scratch[out++] = '"';
+                            pos += 2;
+                            continue;
+                        }
+                        pos++;
+                        break;
+                    }
+                    scratch[out++] = line[pos++];
+                }
+                fields.emplace_back(scratch.data() + start, out - start);
+
+                // Skip anything between the closing quote and the delimiter
+                size_t next = line.find(delimiter, pos);
+                if (next == std::string_view::npos) {
+                    break;
+                }
+                pos = next + 1;
+            } else {
+                size_t next = line.find(delimiter, pos);
+                if (next == std::string_view::npos) {
+                    fields.push_back(line.substr(pos));
+                    break;
+                }
+                fields.push_back(line.substr(pos, next - pos));
+                pos = next + 1;
+            }
+        }
+
+        return static_cast<int>(fields.size());
+    }
+
+    /**
+     * @brief Get the number of fields in the current line
+     * @return The field count
+     */
+    int size() const { return static_cast<int>(fields.size()); }
+
+    /**
+     * @brief Get a field of the current line
+     * @param index Zero-based field index
+     * @return The field, or an empty view if it does not exist
+     */
+    std::string_view operator[](int index) const {
+        return index >= 0 && index < static_cast<int>(fields.size()) ? fields[index] : std::string_view();
+    }
+
+    /**
+     * @brief Trim leading and trailing spaces and tabs
+     * @param text The text to trim
+     * @return The trimmed view
+     */
+    static std::string_view trim(std::string_view text) {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    /**
+     * @brief Parse an integer field
+     * @param text The field (surrounding spaces and a leading '+' are allowed)
+     * @param value Output parameter for the value
+     * @return true if the whole field is a valid integer, false otherwise
+     */
+    template <typename Int>
+    static bool parseInt(std::string_view text, Int& value) {
+        text = trim(text);
+        if (!text.empty() && text.front() == '+') {
+            text.remove_prefix(1);
+        }
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+
+    /**
+     * @brief Parse a floating-point field
+     * @param text The field (surrounding spaces and a leading '+' are allowed)
+     * @param value Output parameter for the value
+     * @return true if the whole field is a valid number, false otherwise
+     */
+    static bool parseDouble(std::string_view text, double& value) {
+        text = trim(text);
+        if (!text.empty() && text.front() == '+') {
+            text.remove_prefix(1);
+        }
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+};
+
+#endif // CSV_TOKENIZER_H
@@ -0,0 +1,214 @@
+/**
+ * @file CSVTokenizerBenchmark.cpp
+ * @brief Throughput benchmark for the CSV tokenizer and structural scanner.
+ *
+ * Parses a CSV file several times with the original stringstream/getline/stod
+ * approach, with CSVLineReader + CSVTokenizer, with CSVBulkReader over a stream
+ * and with CSVBulkReader over a MappedFile, and reports MB/s for each. The file
+ * is opened on every pass, so those numbers include I/O. The raw structural
+ * scan is also timed on the file held in memory.
+ *
+ * Build: g++ -std=c++17 -O2 -o csv_benchmark CSVTokenizerBenchmark.cpp
+ *        (add -mavx2 or -march=native for the AVX2 scanner)
+ * Usage: ./csv_benchmark [csv_file] [passes]
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "CSVTokenizer.h"
+#include "CSVScanner.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+/**
+ * @brief Parse the file the way the ingest paths used to (stringstream + getline + stod)
+ * @param filename The CSV file
+ * @param checksum Accumulates parsed values so the work is not optimized away
+ * @return The number of records parsed
+ */
+long parseWithStringstream(const string& filename, double& checksum) {
+    ifstream file(filename);
+    string line;
+    getline(file, line); // Skip header
+
+    long count = 0;
+    while (getline(file, line)) {
+        stringstream ss(line);
+        vector<string> parts;
+        string item;
+        while (getline(ss, item, ',')) {
+            parts.push_back(item);
+        }
+        if (parts.size() >= 6) {
+            try {
+                checksum += stoi(parts[0]) + stod(parts[4]) + stod(parts[5]) + parts[1].size();
+            } catch (...) {
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Parse the file with CSVLineReader and CSVTokenizer
+ * @param filename The CSV file
+ * @param checksum Accumulates parsed values so the work is not optimized away
+ * @return The number of records parsed
+ */
+long parseWithTokenizer(const string& filename, double& checksum) {
+    ifstream file(filename, ios::binary);
+    CSVLineReader reader(file);
+    CSVTokenizer tokenizer;
+    string_view line;
+    reader.nextLine(line); // Skip header
+
+    long count = 0;
+    while (reader.nextLine(line)) {
+        if (tokenizer.split(line) >= 6) {
+            int zip = 0;
+            double lat = 0.0, lon = 0.0;
+            if (CSVTokenizer::parseInt(tokenizer[0], zip) && CSVTokenizer::parseDouble(tokenizer[4], lat) &&
+                CSVTokenizer::parseDouble(tokenizer[5], lon)) {
+                checksum += zip + lat + lon + tokenizer[1].size();
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Parse the file with CSVBulkReader (vectorized structural index)
+ * @param filename The CSV file
+ * @param checksum Accumulates parsed values so the work is not optimized away
+ * @return The number of records parsed
+ */
+long parseWithBulkReader(const string& filename, double& checksum) {
+    ifstream file(filename, ios::binary);
+    CSVBulkReader reader(file);
+    string_view line;
+    reader.nextRecord(line); // Skip header
+
+    long count = 0;
+    while (reader.nextRecord(line)) {
+        if (reader.size() >= 6) {
+            int zip = 0;
+            double lat = 0.0, lon = 0.0;
+            if (CSVTokenizer::parseInt(reader[0], zip) && CSVTokenizer::parseDouble(reader[4], lat) &&
+                CSVTokenizer::parseDouble(reader[5], lon)) {
+                checksum += zip + lat + lon + reader[1].size();
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Parse the file with CSVBulkReader over a memory-mapped file (no copy into a read buffer)
+ * @param filename The CSV file
+ * @param checksum Accumulates parsed values so the work is not optimized away
+ * @return The number of records parsed
+ */
+long parseWithMappedFile(const string& filename, double& checksum) {
+    MappedFile file(filename);
+    CSVBulkReader reader(file.data(), file.size());
+    string_view line;
+    reader.nextRecord(line); // Skip header
+
+    long count = 0;
+    while (reader.nextRecord(line)) {
+        if (reader.size() >= 6) {
+            int zip = 0;
+            double lat = 0.0, lon = 0.0;
+            if (CSVTokenizer::parseInt(reader[0], zip) && CSVTokenizer::parseDouble(reader[4], lat) &&
+                CSVTokenizer::parseDouble(reader[5], lon)) {
+                checksum += zip + lat + lon + reader[1].size();
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Time the structural scan alone over bytes already in memory
+ * @param data The file contents
+ * @param passes Number of passes
+ */
+void runScanBenchmark(const string& data, int passes) {
+    CSVStructuralIndexer indexer;
+    vector<uint32_t> positions;
+    size_t structurals = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < passes; i++) {
+        indexer.reset();
+        structurals += indexer.index(data.data(), data.size(), positions);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    double megabytes = static_cast<double>(data.size()) * passes / (1024.0 * 1024.0);
+    cout << "structural scan (in memory): " << structurals / passes << " positions/pass, "
+         << megabytes / seconds << " MB/s" << endl;
+}
+
+/**
+ * @brief Time several passes of a parser and print its throughput
+ * @param name Label for the output
+ * @param parser The parse function
+ * @param filename The CSV file
+ * @param fileBytes Size of the file in bytes
+ * @param passes Number of passes
+ */
+void runBenchmark(const string& name, long (*parser)(const string&, double&),
+                  const string& filename, long fileBytes, int passes) {
+    double checksum = 0.0;
+    long records = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < passes; i++) {
+        records = parser(filename, checksum);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    double megabytes = static_cast<double>(fileBytes) * passes / (1024.0 * 1024.0);
+    cout << name << ": " << records << " records/pass, " << megabytes / seconds << " MB/s"
+         << " (checksum " << checksum << ")" << endl;
+}
+
+/**
+ * @brief Main function for the tokenizer benchmark.
+ * @param argc Argument count
+ * @param argv Argument values: [csv_file] [passes]
+ * @return 0 on success, 1 if the file cannot be opened.
+ */
+int main(int argc, char* argv[]) {
+    string filename = (argc > 1) ? argv[1] : "us_postal_codes.csv";
+    int passes = (argc > 2) ? stoi(argv[2]) : 20;
+
+    ifstream probe(filename, ios::binary | ios::ate);
+    if (!probe.is_open()) {
+        cerr << "Error: Could not open " << filename << endl;
+        return 1;
+    }
+    long fileBytes = probe.tellg();
+    string contents(fileBytes, '\0');
+    probe.seekg(0);
+    probe.read(&contents[0], fileBytes);
+    probe.close();
+
+    cout << "File: " << filename << " (" << fileBytes << " bytes), " << passes << " passes" << endl;
+    runBenchmark("stringstream", parseWithStringstream, filename, fileBytes, passes);
+    runBenchmark("CSVTokenizer", parseWithTokenizer, filename, fileBytes, passes);
+    runBenchmark("CSVBulkReader", parseWithBulkReader, filename, fileBytes, passes);
+    runBenchmark("CSVBulkReader (mapped)", parseWithMappedFile, filename, fileBytes, passes);
+    runScanBenchmark(contents, passes * 10);
+    return 0;
+}
@@ -0,0 +1,265 @@
+/**
+ * @file CompactZipCodeRecord.h
+ * @brief Definition of the CompactZipCodeRecord class, a 32-byte in-memory form of ZipCodeRecord
+ *
+ * The Zip Code is held as an integer and its digit count, the state as two
+ * inline characters, and the city and county as codes into a RecordDictionary
+ * shared by all records of a load. Records have no heap storage of their own,
+ * so large vectors of them sort and compare without touching strings.
+ * ZipCodeRecord remains the type used everywhere else; convert with
+ * assignRecord() and toRecord().
+ */
+
+#ifndef COMPACT_ZIPCODE_RECORD_H
+#define COMPACT_ZIPCODE_RECORD_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include "ZipCodeRecord.h"
+#include "RecordDictionary.h"
+#include "CSVTokenizer.h"
+
+/**
+ * @class CompactZipCodeRecord
+ * @brief Fixed-size Zip Code record with interned city and county names
+ */
+class CompactZipCodeRecord {
+public:
+    /// Longest Zip Code (in digits, leading zeros included) that fits the integer form
+    static constexpr int MAX_ZIP_DIGITS = 9;
+
+private:
+    uint32_t zip;             ///< Numeric value of the Zip Code
+    uint32_t cityCode;        ///< City name code (DICT_CITY)
+    uint32_t countyCode;      ///< County name code (DICT_COUNTY)
+    uint8_t zipDigits;        ///< Digits in the Zip Code, leading zeros included
+    uint8_t stateLength;      ///< Characters used in state (0 to 2)
+    char state[2];            ///< State abbreviation
+    double latitude;          ///< Latitude coordinate
+    double longitude;         ///< Longitude coordinate
+
+    /**
+     * @brief Power of ten for a digit count
+     * @param digits 0 to MAX_ZIP_DIGITS
+     * @return 10^digits
+     */
+    static uint64_t powerOfTen(int digits) {
+        static const uint64_t powers[MAX_ZIP_DIGITS + 1] = {
+            1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+        };
+        return powers[digits];
+    }
+
+    /**
+     * @brief Store the Zip Code and state
+     * @param zipText The Zip Code text
+     * @param stateText The state text
+     * @return true if the Zip Code is 1 to MAX_ZIP_DIGITS digits and the state at most 2 characters
+     */
+    bool assignKey(std::string_view zipText, std::string_view stateText) {
+        if (zipText.empty() || zipText.size() > static_cast<size_t>(MAX_ZIP_DIGITS) ||
+            stateText.size() > sizeof(state)) {
+            return false;
+        }
+        uint32_t value = 0;
+        for (char c : zipText) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            value = value * 10 + (c - '0');
+        }
+
+        zip = value;
+        zipDigits = static_cast<uint8_t>(zipText.size());
+        stateLength = static_cast<uint8_t>(stateText.size());
+        state[0] = stateLength > 0 ? stateText[0] : '\0';
+        state[1] = stateLength > 1 ? stateText[1] : '\0';
+        return true;
+    }
+
+public:
+    /**
+     * @brief Default constructor
+     */
+    CompactZipCodeRecord()
+        : zip(0), cityCode(0), countyCode(0), zipDigits(0), stateLength(0), state{'\0', '\0'},
+          latitude(0.0), longitude(0.0) {}
+
+    /**
+     * @brief Overwrite this record from already-split CSV fields
+     * @param fields Field source with size() and operator[] (CSVTokenizer or CSVBulkReader)
+     * @param names Dictionary the city and county names are interned in
+     * @return true if successful, false if there are fewer than 6 fields or the key does not fit
+     */
+    template <typename Fields>
+    bool assignFields(const Fields& fields, RecordDictionary& names) {
+        if (fields.size() < 6 || !assignKey(fields[0], fields[2])) {
+            return false;
+        }
+        cityCode = names.encode(DICT_CITY, fields[1]);
+        countyCode = names.encode(DICT_COUNTY, fields[3]);
+
+        // Unparseable coordinates default to 0.0, as in ZipCodeRecord
+        if (!CSVTokenizer::parseDouble(fields[4], latitude)) latitude = 0.0;
+        if (!CSVTokenizer::parseDouble(fields[5], longitude)) longitude = 0.0;
+        return true;
+    }
+
+    /**
+     * @brief Overwrite this record from a ZipCodeRecord
+     * @param record The record to convert
+     * @param names Dictionary the city and county names are interned in
+     * @return true if successful, false if the key does not fit
+     */
+    bool assignRecord(const ZipCodeRecord& record, RecordDictionary& names) {
+        if (!assignKey(record.getZipCode(), record.getStateName())) {
+            return false;
+        }
+        cityCode = names.encode(DICT_CITY, record.getCityName());
+        countyCode = names.encode(DICT_COUNTY, record.getCountyName());
+        latitude = record.getLatitude();
+        longitude = record.getLongitude();
+        return true;
+    }
+
+    /**
+     * @brief Write the record into a ZipCodeRecord, reusing its string capacity
+     * @param record Output parameter for the record
+     * @param names Dictionary the record's names were interned in
+     */
+    void copyTo(ZipCodeRecord& record, const RecordDictionary& names) const {
+        char zipText[MAX_ZIP_DIGITS];
+        record.assign(std::string_view(zipText, formatZipCode(zipText)), getCityName(names),
+                      getStateName(), getCountyName(names), latitude, longitude);
+    }
+
+    /**
+     * @brief Convert to a ZipCodeRecord
+     * @param names Dictionary the record's names were interned in
+     * @return The equivalent ZipCodeRecord
+     */
+    ZipCodeRecord toRecord(const RecordDictionary& names) const {
+        ZipCodeRecord record;
+        copyTo(record, names);
+        return record;
+    }
+
+    /**
+     * @brief Write the Zip Code text, leading zeros included
+     * @param out Buffer of at least MAX_ZIP_DIGITS characters (not null-terminated)
+     * @return The number of characters written
+     */
+    int formatZipCode(char* out) const {
+        uint32_t value = zip;
+        for (int i = zipDigits - 1; i >= 0; i--) {
+            out[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        return zipDigits;
+    }
+
+    /**
+     * @brief Get the Zip Code text
+     * @return The Zip Code
+     */
+    std::string getZipCode() const {
+        char zipText[MAX_ZIP_DIGITS];
+        return std::string(zipText, formatZipCode(zipText));
+    }
+
+    /**
+     * @brief Get the numeric value of the Zip Code
+     * @return The Zip Code as an integer
+     */
+    uint32_t getZipValue() const { return zip; }
+
+    /**
+     * @brief Get a key whose integer order matches the string order of Zip Codes
+     *
+     * Left-aligning the digits (so "501" and "00501" sort as text would) and
+     * appending the digit count makes a plain integer comparison agree with
+     * ZipCodeRecord::operator<.
+     * @return The sort key
+     */
+    uint64_t getZipOrderKey() const {
+        return (zip * powerOfTen(MAX_ZIP_DIGITS - zipDigits)) << 4 | zipDigits;
+    }
+
+    /**
+     * @brief Get the sort key of a Zip Code string without building a record
+     * @param zipText The Zip Code text
+     * @param key Output parameter for the key (same order as getZipOrderKey)
+     * @return true if the Zip Code is 1 to MAX_ZIP_DIGITS digits
+     */
+    static bool zipOrderKey(std::string_view zipText, uint64_t& key) {
+        if (zipText.empty() || zipText.size() > static_cast<size_t>(MAX_ZIP_DIGITS)) {
+            return false;
+        }
+        uint64_t value = 0;
+        for (char c : zipText) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            value = value * 10 + (c - '0');
+        }
+        key = (value * powerOfTen(MAX_ZIP_DIGITS - static_cast<int>(zipText.size()))) << 4 | zipText.size();
+        return true;
+    }
+
+    /**
+     * @brief Get the city name
+     * @param names Dictionary the record's names were interned in
+     * @return The city name (valid while the dictionary lives)
+     */
+    std::string_view getCityName(const RecordDictionary& names) const {
+        return names.decode(DICT_CITY, cityCode);
+    }
+
+    /**
+     * @brief Get the state name
+     * @return The state name (valid while the record lives)
+     */
+    std::string_view getStateName() const { return std::string_view(state, stateLength); }
+
+    /**
+     * @brief Get the county name
+     * @param names Dictionary the record's names were interned in
+     * @return The county name (valid while the dictionary lives)
+     */
+    std::string_view getCountyName(const RecordDictionary& names) const {
+        return names.decode(DICT_COUNTY, countyCode);
+    }
+
+    /**
+     * @brief Get the latitude
+     * @return The latitude
+     */
+    double getLatitude() const { return latitude; }
+
+    /**
+     * @brief Get the longitude
+     * @return The longitude
+     */
+    double getLongitude() const { return longitude; }
+
+    /**
+     * @brief Comparison operator for sorting by Zip Code (same order as ZipCodeRecord)
+     * @param other Another CompactZipCodeRecord
+     * @return true if this record's Zip Code is less than the other's
+     */
+    bool operator<(const CompactZipCodeRecord& other) const {
+        return getZipOrderKey() < other.getZipOrderKey();
+    }
+
+    /**
+     * @brief Equality operator
+     * @param other Another CompactZipCodeRecord
+     * @return true if the Zip Codes are the same
+     */
+    bool operator==(const CompactZipCodeRecord& other) const {
+        return zip == other.zip && zipDigits == other.zipDigits;
+    }
+};
+
+#endif // COMPACT_ZIPCODE_RECORD_H
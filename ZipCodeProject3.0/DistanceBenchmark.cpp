@@ -0,0 +1,111 @@
+/**
+ * @file DistanceBenchmark.cpp
+ * @brief Times distance matrices with the batch kernel against one-at-a-time library trig.
+ *
+ * Reads the Zip Code locations of a CSV file, takes an evenly spaced
+ * sample of them and computes the full distance matrix of the sample
+ * twice: pair by pair with the haversine formula on library sin, cos and
+ * asin, and in one batch with ZipDistances::manyToMany, which computes
+ * only the upper triangle of a set against itself. It prints both times
+ * and the largest difference between the two matrices.
+ *
+ * Build: g++ -std=c++17 -O2 -o distance_benchmark DistanceBenchmark.cpp
+ *        (add -mavx2 -mfma or -march=native for the AVX2 kernel)
+ * Usage: ./distance_benchmark [csv_file] [zip_codes]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include "CSVTokenizer.h"
+#include "ZipDistances.h"
+
+using namespace std;
+
+/**
+ * @brief Haversine distance with the library trig functions, the baseline the batch kernel is timed against
+ */
+double libraryDistanceKm(double latitude1, double longitude1, double latitude2, double longitude2) {
+    const double radians = M_PI / 180.0;
+    double deltaLatitude = (latitude2 - latitude1) * radians;
+    double deltaLongitude = (longitude2 - longitude1) * radians;
+    double a = sin(deltaLatitude / 2) * sin(deltaLatitude / 2) +
+               cos(latitude1 * radians) * cos(latitude2 * radians) * sin(deltaLongitude / 2) * sin(deltaLongitude / 2);
+    return 2 * ZipDistances::EARTH_RADIUS_KM * asin(min(1.0, sqrt(a)));
+}
+
+int main(int argc, char* argv[]) {
+    string filename = (argc > 1) ? argv[1] : "us_postal_codes.csv";
+    size_t sampleSize = (argc > 2) ? stoul(argv[2]) : 3000;
+
+    ifstream file(filename, ios::binary);
+    CSVLineReader reader(file);
+    CSVTokenizer tokenizer;
+    string_view line;
+    reader.nextLine(line); // Skip header
+
+    vector<double> latitudes, longitudes;
+    while (reader.nextLine(line)) {
+        double latitude = 0.0, longitude = 0.0;
+        if (tokenizer.split(line) >= 6 && CSVTokenizer::parseDouble(tokenizer[4], latitude) &&
+            CSVTokenizer::parseDouble(tokenizer[5], longitude)) {
+            latitudes.push_back(latitude);
+            longitudes.push_back(longitude);
+        }
+    }
+    if (latitudes.empty()) {
+        cerr << "Error: No locations in " << filename << endl;
+        return 1;
+    }
+
+    // Evenly spaced Zip Codes, so the sample covers every state
+    vector<double> sampleLatitudes, sampleLongitudes;
+    ZipDistances::Points points;
+    size_t step = max<size_t>(1, latitudes.size() / max<size_t>(1, sampleSize));
+    for (size_t i = 0; i < latitudes.size() && sampleLatitudes.size() < sampleSize; i += step) {
+        sampleLatitudes.push_back(latitudes[i]);
+        sampleLongitudes.push_back(longitudes[i]);
+        points.add(latitudes[i], longitudes[i]);
+    }
+    size_t n = points.size();
+
+#if defined(ZIP_DISTANCES_AVX2)
+    const char* kernel = "AVX2";
+#else
+    const char* kernel = "scalar";
+#endif
+    cout << "File: " << filename << ", " << n << " x " << n << " matrix (" << n * n << " distances), "
+         << kernel << " kernel" << endl;
+
+    vector<double> expected(n * n);
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            expected[i * n + j] =
+                libraryDistanceKm(sampleLatitudes[i], sampleLongitudes[i], sampleLatitudes[j], sampleLongitudes[j]);
+        }
+    }
+    double libraryMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    vector<double> matrix;
+    start = chrono::steady_clock::now();
+    ZipDistances::manyToMany(points, points, matrix);
+    double batchMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    double maxDifference = 0.0;
+    for (size_t i = 0; i < matrix.size(); i++) {
+        maxDifference = max(maxDifference, fabs(matrix[i] - expected[i]));
+    }
+
+    cout << fixed << setprecision(1);
+    cout << left << setw(22) << "One at a time (libm)" << right << setw(10) << libraryMs << " ms" << setw(10)
+         << n * n / libraryMs / 1000 << " M/s" << endl;
+    cout << left << setw(22) << "ZipDistances batch" << right << setw(10) << batchMs << " ms" << setw(10)
+         << n * n / batchMs / 1000 << " M/s" << endl;
+    cout << scientific << setprecision(2) << "Largest difference: " << maxDifference << " km" << endl;
+    return 0;
+}
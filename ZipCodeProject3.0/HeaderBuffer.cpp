@@ -4,6 +4,8 @@
  */
 
 #include "HeaderBuffer.h"
+#include "CSVTokenizer.h"
+#include "MappedFile.h"
 
 /**
  * @brief Writes a structured header to the top of the file.
@@ -12,7 +14,7 @@
 void HeaderBuffer::writeHeader(const string& filename, const FileHeader& header) {
     string tempFile = filename + ".tmp";
 
-    ifstream original(filename);
+    MappedFile original(filename);
     ofstream temp(tempFile);
 
     if (!temp.is_open()) {
@@ -39,19 +41,21 @@ void HeaderBuffer::writeHeader(const string& filename, const FileHeader& header)
 
     // Safely skip header lines (only if they exist)
     int linesToSkip = 8 + header.fieldSchemas.size() + 1;
-    string dummy;
+    CSVLineReader reader(original.data(), original.size());
+    string_view dummy;
     int skipped = 0;
-    while (skipped < linesToSkip && getline(original, dummy)) {
+    while (skipped < linesToSkip && reader.nextLine(dummy)) {
         skipped++;
     }
 
-    // Copy remaining data records
-    string line;
-    while (getline(original, line)) {
-        temp << line << '\n';
+    // Copy remaining data records in one write
+    string_view records = original.view().substr(reader.getOffset());
+    temp.write(records.data(), records.size());
+    if (!records.empty() && records.back() != '\n') {
+        temp << '\n';
     }
 
-    // Finalize file replacement
+    // Finalize file replacement (the mapping must be released before the file is replaced)
     original.close();
     temp.close();
     remove(filename.c_str());
@@ -59,43 +63,47 @@ void HeaderBuffer::writeHeader(const string& filename, const FileHeader& header)
 }
 
 HeaderBuffer::FileHeader HeaderBuffer::readHeader(const string& filename) {
-    ifstream file(filename);
-    if (!file.is_open()) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
         cerr << "Error: Could not open file to read header: " << filename << endl;
         return {};
     }
 
-    FileHeader header;
-    getline(file, header.fileType);
-    file >> header.version;
-    file >> header.headerSize;
-    file >> header.recordSizeBytes;
-    file.ignore();
-    getline(file, header.sizeFormat);
-    getline(file, header.indexFileName);
-    file >> header.recordCount;
-    file >> header.fieldCount;
-    file.ignore();
+    // Only the header lines are parsed; the rest of the mapping is never touched
+    CSVLineReader reader(file.data(), file.size());
+    string_view line;
+    auto nextString = [&](string& value) {
+        if (reader.nextLine(line)) value.assign(line);
+    };
+    auto nextInt = [&](int& value) {
+        if (reader.nextLine(line)) CSVTokenizer::parseInt(line, value);
+    };
+
+    FileHeader header{};
+    nextString(header.fileType);
+    nextInt(header.version);
+    nextInt(header.headerSize);
+    nextInt(header.recordSizeBytes);
+    nextString(header.sizeFormat);
+    nextString(header.indexFileName);
+    nextInt(header.recordCount);
+    nextInt(header.fieldCount);
 
     // Read field schemas
-    for (int i = 0; i < header.fieldCount; ++i) {
-        string line;
-        getline(file, line);
+    for (int i = 0; i < header.fieldCount && reader.nextLine(line); ++i) {
         size_t commaPos = line.find(',');
-        if (commaPos != string::npos) {
-            string name = line.substr(0, commaPos);
-            string type = line.substr(commaPos + 1);
+        if (commaPos != string_view::npos) {
+            string name(line.substr(0, commaPos));
+            string type(line.substr(commaPos + 1));
             header.fieldSchemas.push_back({name, type});
         }
     }
 
-    file >> header.primaryKeyField; // Read primary key field position
+    nextInt(header.primaryKeyField); // Read primary key field position
 
-    file.close(); // Close file
     return header;
 }
 
-
 void HeaderBuffer::printHeader(const FileHeader& header) {
     // Print header information to the terminal
     cout << "=== File Header ===" << endl;
@@ -0,0 +1,155 @@
+/**
+ * @file LayoutBenchmark.cpp
+ * @brief Compares zip-ordered and Hilbert-ordered sequence set layouts on spatial queries.
+ *
+ * Builds the same CSV file into a blocked sequence set twice, once with
+ * blocks in Zip Code order and once in Hilbert curve order, then runs the
+ * same radius and bounding-box queries against both. For each layout it
+ * reports the distinct blocks a query has to read (the I/O a cold cache
+ * pays), the records found and the time per query. Point lookups by Zip
+ * Code are timed as well, since the Hilbert layout trades a per-block index
+ * for a per-record one.
+ *
+ * Build: g++ -std=c++17 -O2 -o layout_benchmark LayoutBenchmark.cpp
+ * Usage: ./layout_benchmark [csv_file] [queries] [radius_miles] [block_size]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <set>
+#include <chrono>
+#include <cstdio>
+#include "BSSManager.h"
+#include "ZipGeoIndex.h"
+
+using namespace std;
+
+/**
+ * @brief One query location
+ */
+struct QueryPoint {
+    double latitude;
+    double longitude;
+};
+
+/**
+ * @brief Totals for one layout and query type
+ */
+struct LayoutResult {
+    double blocks = 0;    ///< Distinct blocks read, summed over queries
+    double records = 0;   ///< Records found, summed over queries
+    double micros = 0;    ///< Query time, summed over queries
+};
+
+/**
+ * @brief Count the distinct blocks holding a set of index matches
+ * @param matches Matches from the Z-order index
+ * @return The number of blocks a query returning them reads
+ */
+size_t countBlocks(const vector<ZipGeoIndex::Match>& matches) {
+    set<int> blocks;
+    for (const auto& match : matches) {
+        blocks.insert(match.rbn);
+    }
+    return blocks.size();
+}
+
+/**
+ * @brief Print one line of the results table
+ */
+void printRow(const string& layout, const string& query, const LayoutResult& result, size_t queries) {
+    cout << left << setw(9) << layout << setw(8) << query << right << fixed << setprecision(1)
+         << setw(14) << result.blocks / queries << setw(15) << result.records / queries
+         << setw(12) << result.micros / queries << endl;
+}
+
+int main(int argc, char* argv[]) {
+    string csvFile = (argc > 1) ? argv[1] : "us_postal_codes.csv";
+    size_t queryCount = (argc > 2) ? stoul(argv[2]) : 200;
+    double radiusMiles = (argc > 3) ? stod(argv[3]) : 25.0;
+    int blockSize = (argc > 4) ? stoi(argv[4]) : 512;
+    double radiusKm = radiusMiles * 1.609344;
+    double boxDegrees = radiusMiles / 69.0;  // Half-width of the box queries, about the same area
+
+    const string layouts[] = {"zip", "hilbert"};
+    vector<QueryPoint> points;
+    vector<string> zipCodes;
+
+    cout << "File: " << csvFile << ", " << queryCount << " queries, radius " << radiusMiles
+         << " mi, block size " << blockSize << endl;
+    cout << left << setw(9) << "Layout" << setw(8) << "Query" << right << setw(14) << "Blocks/query"
+         << setw(15) << "Records/query" << setw(12) << "us/query" << endl;
+
+    for (const string& layout : layouts) {
+        string dataFile = "layout_" + layout + ".dat";
+        string indexFile = "layout_" + layout + ".idx";
+        BSSManager manager(dataFile, indexFile);
+        manager.setVerbose(false);
+        if (!manager.initialize(blockSize, "CSV", "none", "blocks", layout) || !manager.createFromCSV(csvFile)) {
+            cerr << "Error: Could not build the " << layout << " layout from " << csvFile << endl;
+            return 1;
+        }
+
+        // Query around evenly spaced records, the same ones for both layouts
+        if (points.empty()) {
+            vector<ZipCodeRecord> all;
+            manager.rangeSearch("", "~", all);
+            size_t step = max<size_t>(1, all.size() / max<size_t>(1, queryCount));
+            for (size_t i = 0; i < all.size() && points.size() < queryCount; i += step) {
+                points.push_back({all[i].getLatitude(), all[i].getLongitude()});
+                zipCodes.push_back(all[i].getZipCode());
+            }
+            if (points.empty()) {
+                cerr << "Error: No records in " << csvFile << endl;
+                return 1;
+            }
+        }
+
+        // Builds the Z-order index, which is then opened again to see which blocks each query reads
+        vector<ZipCodeRecord> records;
+        vector<double> distances;
+        manager.withinRadius(points[0].latitude, points[0].longitude, radiusKm, records, distances);
+        ZipGeoIndex geo;
+        if (!geo.load(indexFile + ".geo")) {
+            cerr << "Error: Could not open " << indexFile << ".geo" << endl;
+            return 1;
+        }
+
+        LayoutResult radius, box, lookup;
+        for (const QueryPoint& point : points) {
+            auto start = chrono::steady_clock::now();
+            manager.withinRadius(point.latitude, point.longitude, radiusKm, records, distances);
+            radius.micros += chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+            radius.records += records.size();
+            radius.blocks += countBlocks(geo.withinRadius(point.latitude, point.longitude, radiusKm));
+
+            double south = point.latitude - boxDegrees, north = point.latitude + boxDegrees;
+            double west = point.longitude - boxDegrees, east = point.longitude + boxDegrees;
+            start = chrono::steady_clock::now();
+            manager.withinBox(south, west, north, east, records);
+            box.micros += chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+            box.records += records.size();
+            box.blocks += countBlocks(geo.withinBox(south, west, north, east));
+        }
+
+        ZipCodeRecord found;
+        auto start = chrono::steady_clock::now();
+        for (const string& zipCode : zipCodes) {
+            lookup.records += manager.search(zipCode, found);
+        }
+        lookup.micros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+        lookup.blocks = lookup.records;
+
+        printRow(layout, "radius", radius, points.size());
+        printRow(layout, "box", box, points.size());
+        printRow(layout, "zip", lookup, zipCodes.size());
+
+        remove(dataFile.c_str());
+        remove(indexFile.c_str());
+        remove((dataFile + ".states").c_str());
+        remove((indexFile + ".geo").c_str());
+    }
+    return 0;
+}
@@ -7,18 +7,27 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include <iomanip>
+#include <cstdlib>
 #include "BSSManager.h"
+#include "QueryServer.h"
 
 /**
  * @brief Print usage information
  */
 void printUsage() {
     std::cout << "Usage:" << std::endl;
-    std::cout << "  ./zipcode_bss create <csv_file> <data_file> <index_file> [block_size]" << std::endl;
+    std::cout << "  ./zipcode_bss create <csv_file> <data_file> <index_file> [block_size] [CSV|binary|dictionary] [none|lz|zstd] [blocks|direct|learned] [zip|hilbert]" << std::endl;
     std::cout << "  ./zipcode_bss search <data_file> <index_file> -Z<zipcode>" << std::endl;
     std::cout << "  ./zipcode_bss insert <data_file> <index_file> <record_file>" << std::endl;
     std::cout << "  ./zipcode_bss delete <data_file> <index_file> <zipcode_file>" << std::endl;
     std::cout << "  ./zipcode_bss dump <data_file> <index_file> [physical|logical|index]" << std::endl;
+    std::cout << "  ./zipcode_bss serve <data_file> <index_file> [socket_path]" << std::endl;
+    std::cout << "  ./zipcode_bss nearest <data_file> <index_file> <latitude> <longitude> [count]" << std::endl;
+    std::cout << "  ./zipcode_bss radius <data_file> <index_file> <latitude> <longitude> <radius> [mi|km]" << std::endl;
+    std::cout << "  ./zipcode_bss box <data_file> <index_file> <min_lat> <min_lon> <max_lat> <max_lon>" << std::endl;
+    std::cout << "  ./zipcode_bss states <data_file> <index_file> [state]" << std::endl;
+    std::cout << "  ./zipcode_bss distances <data_file> <index_file> <zipcode> <zipcode> [...]" << std::endl;
 }
 
 /**
@@ -115,15 +124,22 @@ int main(int argc, char* argv[]) {
         std::string dataFile = argv[3];
         std::string indexFile = argv[4];
         int blockSize = (argc > 5) ? std::stoi(argv[5]) : 512;
+        std::string recordFormat = (argc > 6) ? argv[6] : "CSV";
+        std::string compression = (argc > 7) ? argv[7] : "none";
+        std::string indexMode = (argc > 8) ? argv[8] : "blocks";
+        std::string layout = (argc > 9) ? argv[9] : "zip";
         
         std::cout << "Creating BSS file from " << csvFile << "..." << std::endl;
         std::cout << "Data file: " << dataFile << std::endl;
         std::cout << "Index file: " << indexFile << std::endl;
         std::cout << "Block size: " << blockSize << " bytes" << std::endl;
+        std::cout << "Record format: " << recordFormat << std::endl;
+        std::cout << "Compression: " << compression << std::endl;
+        std::cout << "Index mode: " << indexMode << std::endl;
+        std::cout << "Layout: " << layout << std::endl;
         
         BSSManager manager(dataFile, indexFile);
-        manager.initialize(blockSize);
-        if (manager.createFromCSV(csvFile)) {
+        if (manager.initialize(blockSize, recordFormat, compression, indexMode, layout) && manager.createFromCSV(csvFile)) {
             std::cout << "BSS file created successfully!" << std::endl;
             return 0;
         } else {
@@ -168,6 +184,132 @@ int main(int argc, char* argv[]) {
             return 1;
         }
     }
+    else if (command == "nearest" && argc >= 6) {
+        std::string dataFile = argv[2];
+        std::string indexFile = argv[3];
+        double latitude = std::atof(argv[4]);
+        double longitude = std::atof(argv[5]);
+        int count = (argc > 6) ? std::atoi(argv[6]) : 5;
+        
+        std::cout << "Finding the " << count << " nearest zip codes to " << latitude << ", " << longitude << "..." << std::endl;
+        
+        BSSManager manager(dataFile, indexFile);
+        std::vector<ZipCodeRecord> records;
+        std::vector<double> distances;
+        if (manager.nearest(latitude, longitude, count, records, distances) == 0) {
+            std::cout << "No zip codes found." << std::endl;
+            return 1;
+        }
+        for (size_t i = 0; i < records.size(); i++) {
+            std::cout << std::fixed << std::setprecision(2) << std::setw(9) << distances[i] << " km  "
+                      << records[i].toCSV() << std::endl;
+        }
+        return 0;
+    }
+    else if (command == "radius" && argc >= 7) {
+        std::string dataFile = argv[2];
+        std::string indexFile = argv[3];
+        double latitude = std::atof(argv[4]);
+        double longitude = std::atof(argv[5]);
+        double radius = std::atof(argv[6]);
+        std::string unit = (argc > 7) ? argv[7] : "mi";
+        double kmPerUnit = (unit == "km") ? 1.0 : 1.609344;
+        
+        std::cout << "Finding zip codes within " << radius << " " << unit << " of " << latitude << ", " << longitude << "..." << std::endl;
+        
+        BSSManager manager(dataFile, indexFile);
+        std::vector<ZipCodeRecord> records;
+        std::vector<double> distances;
+        manager.withinRadius(latitude, longitude, radius * kmPerUnit, records, distances);
+        for (size_t i = 0; i < records.size(); i++) {
+            std::cout << std::fixed << std::setprecision(2) << std::setw(9) << distances[i] / kmPerUnit << " " << unit
+                      << "  " << records[i].toCSV() << std::endl;
+        }
+        std::cout << records.size() << " zip codes found." << std::endl;
+        return records.empty() ? 1 : 0;
+    }
+    else if (command == "box" && argc >= 8) {
+        std::string dataFile = argv[2];
+        std::string indexFile = argv[3];
+        
+        BSSManager manager(dataFile, indexFile);
+        std::vector<ZipCodeRecord> records;
+        manager.withinBox(std::atof(argv[4]), std::atof(argv[5]), std::atof(argv[6]), std::atof(argv[7]), records);
+        for (const auto& record : records) {
+            std::cout << record.toCSV() << std::endl;
+        }
+        std::cout << records.size() << " zip codes found." << std::endl;
+        return records.empty() ? 1 : 0;
+    }
+    else if (command == "states" && argc >= 4) {
+        std::string dataFile = argv[2];
+        std::string indexFile = argv[3];
+        
+        BSSManager manager(dataFile, indexFile);
+        std::vector<StateAggregates::Summary> summaries;
+        if (argc > 4) {
+            StateAggregates::Summary summary;
+            if (manager.getStateSummary(argv[4], summary)) {
+                summaries.push_back(summary);
+            }
+        } else {
+            manager.getStateSummaries(summaries);
+        }
+        if (summaries.empty()) {
+            std::cout << "No records found." << std::endl;
+            return 1;
+        }
+        
+        std::cout << std::left << std::setw(6) << "State" << std::right << std::setw(7) << "Count"
+                  << std::setw(22) << "Centroid" << std::setw(8) << "North" << std::setw(8) << "South"
+                  << std::setw(8) << "East" << std::setw(8) << "West" << std::endl;
+        for (const auto& summary : summaries) {
+            std::cout << std::left << std::setw(6) << summary.state << std::right << std::setw(7) << summary.count
+                      << std::fixed << std::setprecision(4) << std::setw(11) << summary.centroidLatitude()
+                      << std::setw(11) << summary.centroidLongitude() << std::setw(8) << summary.maxLatitude.zipCode
+                      << std::setw(8) << summary.minLatitude.zipCode << std::setw(8) << summary.maxLongitude.zipCode
+                      << std::setw(8) << summary.minLongitude.zipCode << std::endl;
+        }
+        return 0;
+    }
+    else if (command == "distances" && argc >= 6) {
+        std::string dataFile = argv[2];
+        std::string indexFile = argv[3];
+        std::vector<std::string> zipCodes(argv + 4, argv + argc);
+        
+        BSSManager manager(dataFile, indexFile);
+        manager.setVerbose(false);
+        std::vector<ZipCodeRecord> records;
+        std::vector<double> matrix;
+        manager.distanceMatrix(zipCodes, records, matrix);
+        // Records come back in the order of the zip codes, so a mismatch is one not found
+        for (size_t i = 0, found = 0; i < zipCodes.size(); i++) {
+            if (found < records.size() && records[found].getZipCode() == zipCodes[i]) {
+                found++;
+            } else {
+                std::cout << "Zip code " << zipCodes[i] << " not found." << std::endl;
+            }
+        }
+        if (records.size() < 2) {
+            std::cout << "Fewer than two of the zip codes were found." << std::endl;
+            return 1;
+        }
+        
+        // Great-circle distances in km, one row and column per zip code found
+        std::cout << std::setw(7) << "km";
+        for (const auto& record : records) {
+            std::cout << std::setw(10) << record.getZipCode();
+        }
+        std::cout << std::endl;
+        for (size_t i = 0; i < records.size(); i++) {
+            std::cout << std::setw(7) << records[i].getZipCode();
+            for (size_t j = 0; j < records.size(); j++) {
+                std::cout << std::fixed << std::setprecision(1) << std::setw(10) << matrix[i * records.size() + j];
+            }
+            std::cout << std::endl;
+        }
+        return 0;
+    }
     else if (command == "insert" && argc >= 5) {
         std::string dataFile = argv[2];
         std::string indexFile = argv[3];
@@ -233,6 +375,33 @@ int main(int argc, char* argv[]) {
         std::cout << "Deleted " << count << " records." << std::endl;
         return 0;
     }
+    else if (command == "serve" && argc >= 4) {
+        std::string dataFile = argv[2];
+        std::string indexFile = argv[3];
+        std::string socketPath = (argc > 4) ? argv[4] : "";
+        
+        // Keep the index and data file open and answer one Zip Code per line:
+        // "OK zip,city,state,county,lat,lon" or "NOT_FOUND zip"
+        BSSManager manager(dataFile, indexFile);
+        manager.setVerbose(false);
+        ZipCodeRecord record;
+        QueryServer server([&](std::string_view query, std::string& response) {
+            std::string zipCode(query);
+            if (manager.search(zipCode, record)) {
+                response = "OK " + record.toCSV();
+            } else {
+                response = "NOT_FOUND " + zipCode;
+            }
+        });
+        
+        std::cerr << "Serving queries from " << (socketPath.empty() ? "stdin" : socketPath) << std::endl;
+        if (!socketPath.empty()) {
+            return server.serveSocket(socketPath) ? 0 : 1;
+        }
+        std::ios::sync_with_stdio(false);
+        server.serveStream(std::cin, std::cout);
+        return 0;
+    }
     else if (command == "dump" && argc >= 4) {
         std::string dataFile = argv[2];
         std::string indexFile = argv[3];
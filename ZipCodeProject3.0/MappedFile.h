@@ -0,0 +1,165 @@
+/**
+ * @file MappedFile.h
+ * @brief Definition of the MappedFile class for read-only access to a whole file as one byte range
+ *
+ * On POSIX systems the file is memory-mapped and the kernel is told it will be
+ * read sequentially; elsewhere, or if mapping fails, the file is read into a
+ * buffer once. Either way callers parse the bytes in place.
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <cstddef>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define MAPPED_FILE_USE_MMAP 1
+#endif
+
+/**
+ * @class MappedFile
+ * @brief Read-only view of a whole file
+ */
+class MappedFile {
+private:
+    const char* bytes;        ///< Start of the file contents
+    size_t length;            ///< Size of the file in bytes
+    bool mapped;              ///< Whether bytes points to a memory mapping
+    bool opened;              ///< Whether a file is open
+    std::string fallback;     ///< File contents when mapping is unavailable
+
+    /**
+     * @brief Read the whole file into the fallback buffer
+     * @param fileName Name of the file
+     * @return true if successful, false otherwise
+     */
+    bool readAll(const std::string& fileName) {
+        std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::streamoff size = file.tellg();
+        fallback.resize(size > 0 ? static_cast<size_t>(size) : 0);
+        file.seekg(0);
+        file.read(&fallback[0], fallback.size());
+        bytes = fallback.data();
+        length = static_cast<size_t>(file.gcount());
+        return true;
+    }
+
+public:
+    /**
+     * @brief Default constructor (no file)
+     */
+    MappedFile() : bytes(nullptr), length(0), mapped(false), opened(false) {}
+
+    /**
+     * @brief Constructor that opens a file
+     * @param fileName Name of the file
+     */
+    explicit MappedFile(const std::string& fileName) : MappedFile() {
+        open(fileName);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Destructor; unmaps the file
+     */
+    ~MappedFile() { close(); }
+
+    /**
+     * @brief Open a file, mapping it if possible
+     * @param fileName Name of the file
+     * @return true if successful, false if the file cannot be read
+     */
+    bool open(const std::string& fileName) {
+        close();
+
+#ifdef MAPPED_FILE_USE_MMAP
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+            if (st.st_size == 0) {
+                // Empty files cannot be mapped but are valid input
+                ::close(fd);
+                opened = true;
+                return true;
+            }
+            void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+                ::close(fd); // The mapping stays valid after the descriptor is closed
+                bytes = static_cast<const char*>(p);
+                length = static_cast<size_t>(st.st_size);
+                mapped = true;
+                opened = true;
+                return true;
+            }
+        }
+        ::close(fd);
+#endif
+
+        opened = readAll(fileName);
+        return opened;
+    }
+
+    /**
+     * @brief Release the file
+     */
+    void close() {
+#ifdef MAPPED_FILE_USE_MMAP
+        if (mapped) {
+            munmap(const_cast<char*>(bytes), length);
+        }
+#endif
+        std::string().swap(fallback);
+        bytes = nullptr;
+        length = 0;
+        mapped = false;
+        opened = false;
+    }
+
+    /**
+     * @brief Check if a file is open
+     * @return true if open() succeeded
+     */
+    bool isOpen() const { return opened; }
+
+    /**
+     * @brief Check if the contents are memory-mapped
+     * @return true if mapped, false if read into a buffer
+     */
+    bool isMapped() const { return mapped; }
+
+    /**
+     * @brief Get the file contents
+     * @return Start of the bytes (nullptr for an empty file)
+     */
+    const char* data() const { return bytes; }
+
+    /**
+     * @brief Get the file size
+     * @return The number of bytes
+     */
+    size_t size() const { return length; }
+
+    /**
+     * @brief Get the file contents as a view
+     * @return The bytes
+     */
+    std::string_view view() const { return std::string_view(bytes, length); }
+};
+
+#endif // MAPPED_FILE_H
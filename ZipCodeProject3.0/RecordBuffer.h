@@ -7,9 +7,112 @@
 #define RECORD_BUFFER_H
 
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <iomanip>
+#include <charconv>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include "ZipCodeRecord.h"
+#include "RecordDictionary.h"
+#include "LittleEndian.h"
+
+/**
+ * @brief Encodings for the record payload that follows the length prefix
+ */
+enum RecordFormat {
+    RECORD_FORMAT_CSV = 0,      ///< Comma-separated text (toCSV/fromCSV)
+    RECORD_FORMAT_BINARY = 1,   ///< Compact binary layout (see RecordBuffer::encodeBinary)
+    RECORD_FORMAT_DICTIONARY = 2 ///< Binary layout with dictionary codes (see RecordBuffer::encodeDictionary)
+};
+
+/// Number of fixed-width bytes at the start of a binary record (zip, lat, lon, zip digits)
+const int BINARY_RECORD_FIXED_BYTES = 13;
+
+/// Offset of the Zip Code digit count, which restores leading zeros the integer drops
+const int BINARY_ZIP_DIGITS_OFFSET = 12;
+
+/// Most digits a binary Zip Code can have (the width of a 32-bit value)
+const int MAX_BINARY_ZIP_DIGITS = 10;
+
+/// Scale for fixed-point coordinates (1e-6 degree resolution)
+const double BINARY_COORD_SCALE = 1000000.0;
+
+/**
+ * @brief Load a fixed-point coordinate of a binary record
+ * @param in The coordinate's 4 bytes
+ * @return The coordinate in degrees
+ */
+inline double decodeBinaryCoordinate(const char* in) {
+    return static_cast<int32_t>(static_cast<uint32_t>(getLE(in, 4))) / BINARY_COORD_SCALE;
+}
+
+/**
+ * @brief Write the Zip Code of a binary record as text, leading zeros included
+ * @param fixed The record's fixed-width fields (at least BINARY_RECORD_FIXED_BYTES bytes)
+ * @param out Destination (at least MAX_BINARY_ZIP_DIGITS bytes)
+ * @return The number of characters written
+ */
+inline int formatBinaryZip(const char* fixed, char* out) {
+    uint32_t value = static_cast<uint32_t>(getLE(fixed, 4));
+    int digits = static_cast<unsigned char>(fixed[BINARY_ZIP_DIGITS_OFFSET]);
+    digits = std::max(1, std::min(digits, MAX_BINARY_ZIP_DIGITS));
+    for (int i = digits - 1; i >= 0; i--) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return digits;
+}
+
+/**
+ * @brief Append an unsigned LEB128 varint
+ * @param out The string to append to
+ * @param value The value to encode
+ */
+inline void appendVarint(std::string& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+/**
+ * @brief Decode an unsigned LEB128 varint
+ * @param data The bytes to decode from
+ * @param pos Position to start at; advanced past the varint
+ * @param value Output parameter for the decoded value
+ * @return true if a complete varint was decoded, false otherwise
+ */
+inline bool readVarint(std::string_view data, size_t& pos, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && pos < data.size(); shift += 7) {
+        unsigned char byte = static_cast<unsigned char>(data[pos++]);
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Read a varint-length-prefixed string
+ * @param data The bytes to decode from
+ * @param pos Position to start at; advanced past the string
+ * @param field Output parameter viewing the string bytes
+ * @return true if successful, false if the data is truncated
+ */
+inline bool readVarString(std::string_view data, size_t& pos, std::string_view& field) {
+    uint32_t len = 0;
+    if (!readVarint(data, pos, len) || len > data.size() - pos) {
+        return false;
+    }
+    field = data.substr(pos, len);
+    pos += len;
+    return true;
+}
 
 /**
  * @class RecordBuffer
@@ -20,15 +123,152 @@ private:
     std::string buffer;       ///< Internal buffer for the record
     int sizeBytes;            ///< Number of bytes used for record size
     bool isBinary;            ///< Flag for binary or ASCII format
+    RecordFormat format;      ///< Encoding of the record payload
+    RecordDictionary* dictionary; ///< String dictionary for RECORD_FORMAT_DICTIONARY
+
+    /**
+     * @brief Encode the fixed-width zip and coordinate fields shared by the binary layouts
+     * @param record The record to encode
+     * @param out Output parameter, cleared and filled with BINARY_RECORD_FIXED_BYTES bytes
+     * @return true if successful, false if the Zip Code is not numeric or too long
+     */
+    static bool encodeFixedFields(const ZipCodeRecord& record, std::string& out) {
+        const std::string& zip = record.getZipCode();
+        uint32_t zipValue = 0;
+        auto result = std::from_chars(zip.data(), zip.data() + zip.size(), zipValue);
+        if (zip.empty() || zip.size() > static_cast<size_t>(MAX_BINARY_ZIP_DIGITS) ||
+            result.ec != std::errc() || result.ptr != zip.data() + zip.size()) {
+            return false;
+        }
+
+        out.clear();
+        out.resize(BINARY_RECORD_FIXED_BYTES);
+        putLE(&out[0], zipValue, 4);
+        putLE(&out[4], static_cast<uint32_t>(static_cast<int32_t>(
+            std::lround(record.getLatitude() * BINARY_COORD_SCALE))), 4);
+        putLE(&out[8], static_cast<uint32_t>(static_cast<int32_t>(
+            std::lround(record.getLongitude() * BINARY_COORD_SCALE))), 4);
+        out[BINARY_ZIP_DIGITS_OFFSET] = static_cast<char>(zip.size());
+        return true;
+    }
 
 public:
     /**
      * @brief Default constructor
      * @param recordSizeBytes Number of bytes used for record size
      * @param isBinaryFormat Flag for binary or ASCII format
+     * @param recordFormat Encoding of the record payload
+     * @param dict String dictionary (required for RECORD_FORMAT_DICTIONARY)
      */
-    RecordBuffer(int recordSizeBytes = 4, bool isBinaryFormat = false)
-        : sizeBytes(recordSizeBytes), isBinary(isBinaryFormat) {}
+    RecordBuffer(int recordSizeBytes = 4, bool isBinaryFormat = false,
+                 RecordFormat recordFormat = RECORD_FORMAT_CSV, RecordDictionary* dict = nullptr)
+        : sizeBytes(recordSizeBytes), isBinary(isBinaryFormat), format(recordFormat),
+          dictionary(dict) {}
+
+    /**
+     * @brief Encode a record in the compact binary layout
+     *
+     * Layout: uint32 zip, int32 latitude and int32 longitude (fixed-point,
+     * BINARY_COORD_SCALE), uint8 count of zip digits (so "02108" keeps its
+     * leading zero), then city, state and county as varint-length-prefixed
+     * bytes. All integers are little-endian.
+     * @param record The record to encode
+     * @param out Output parameter for the encoded bytes
+     * @return true if successful, false if the Zip Code is not numeric or too long
+     */
+    static bool encodeBinary(const ZipCodeRecord& record, std::string& out) {
+        if (!encodeFixedFields(record, out)) {
+            return false;
+        }
+
+        const std::string& city = record.getCityName();
+        const std::string& state = record.getStateName();
+        const std::string& county = record.getCountyName();
+
+        out.reserve(BINARY_RECORD_FIXED_BYTES + 3 * 5 + city.size() + state.size() + county.size());
+        appendVarint(out, city.size());
+        out.append(city);
+        appendVarint(out, state.size());
+        out.append(state);
+        appendVarint(out, county.size());
+        out.append(county);
+        return true;
+    }
+
+    /**
+     * @brief Decode a record from the compact binary layout
+     * @param data The encoded bytes
+     * @return A ZipCodeRecord object (empty if the data is truncated)
+     */
+    static ZipCodeRecord decodeBinary(std::string_view data) {
+        if (data.size() < static_cast<size_t>(BINARY_RECORD_FIXED_BYTES)) {
+            return ZipCodeRecord();
+        }
+
+        size_t pos = BINARY_RECORD_FIXED_BYTES;
+        std::string_view city, state, county;
+        if (!readVarString(data, pos, city) || !readVarString(data, pos, state) ||
+            !readVarString(data, pos, county)) {
+            return ZipCodeRecord();
+        }
+
+        char zip[MAX_BINARY_ZIP_DIGITS];
+        int zipLength = formatBinaryZip(data.data(), zip);
+        double lat = decodeBinaryCoordinate(data.data() + 4);
+        double lon = decodeBinaryCoordinate(data.data() + 8);
+        return ZipCodeRecord(std::string(zip, zipLength), std::string(city),
+                             std::string(state), std::string(county), lat, lon);
+    }
+
+    /**
+     * @brief Encode a record with dictionary codes for the string fields
+     *
+     * Layout: the same fixed-width zip, coordinates and zip digit count as encodeBinary, then
+     * city, state and county as varint codes into the dictionary. Strings not
+     * yet in the dictionary are added.
+     * @param record The record to encode
+     * @param dict The file's string dictionary
+     * @param out Output parameter for the encoded bytes
+     * @return true if successful, false if the Zip Code is not numeric or too long
+     */
+    static bool encodeDictionary(const ZipCodeRecord& record, RecordDictionary& dict, std::string& out) {
+        if (!encodeFixedFields(record, out)) {
+            return false;
+        }
+
+        appendVarint(out, dict.encode(DICT_CITY, record.getCityName()));
+        appendVarint(out, dict.encode(DICT_STATE, record.getStateName()));
+        appendVarint(out, dict.encode(DICT_COUNTY, record.getCountyName()));
+        return true;
+    }
+
+    /**
+     * @brief Decode a record encoded by encodeDictionary
+     * @param data The encoded bytes
+     * @param dict The file's string dictionary
+     * @return A ZipCodeRecord object (empty if the data is truncated)
+     */
+    static ZipCodeRecord decodeDictionary(std::string_view data, const RecordDictionary& dict) {
+        if (data.size() < static_cast<size_t>(BINARY_RECORD_FIXED_BYTES)) {
+            return ZipCodeRecord();
+        }
+
+        size_t pos = BINARY_RECORD_FIXED_BYTES;
+        uint32_t city = 0, state = 0, county = 0;
+        if (!readVarint(data, pos, city) || !readVarint(data, pos, state) ||
+            !readVarint(data, pos, county)) {
+            return ZipCodeRecord();
+        }
+
+        char zip[MAX_BINARY_ZIP_DIGITS];
+        int zipLength = formatBinaryZip(data.data(), zip);
+        double lat = decodeBinaryCoordinate(data.data() + 4);
+        double lon = decodeBinaryCoordinate(data.data() + 8);
+        return ZipCodeRecord(std::string(zip, zipLength),
+                             std::string(dict.decode(DICT_CITY, city)),
+                             std::string(dict.decode(DICT_STATE, state)),
+                             std::string(dict.decode(DICT_COUNTY, county)), lat, lon);
+    }
 
     /**
      * @brief Pack a ZipCodeRecord into the buffer
@@ -36,8 +276,19 @@ public:
      * @return true if packing was successful, false otherwise
      */
     bool pack(const ZipCodeRecord& record) {
-        // Convert record to CSV format
-        std::string csvRecord = record.toCSV();
+        // Encode the record payload
+        std::string csvRecord;
+        if (format == RECORD_FORMAT_BINARY) {
+            if (!encodeBinary(record, csvRecord)) {
+                return false;
+            }
+        } else if (format == RECORD_FORMAT_DICTIONARY) {
+            if (!dictionary || !encodeDictionary(record, *dictionary, csvRecord)) {
+                return false;
+            }
+        } else {
+            csvRecord = record.toCSV();
+        }
         
         // Calculate record size as string
         std::string sizeStr;
@@ -80,7 +331,16 @@ public:
             recordSize = std::stoi(sizeStr);
         }
         
-        // Extract the CSV record
+        // Decode the record payload
+        if (format == RECORD_FORMAT_BINARY) {
+            return decodeBinary(std::string_view(buffer).substr(sizeBytes, recordSize));
+        }
+        if (format == RECORD_FORMAT_DICTIONARY) {
+            if (!dictionary) {
+                return ZipCodeRecord();
+            }
+            return decodeDictionary(std::string_view(buffer).substr(sizeBytes, recordSize), *dictionary);
+        }
         std::string csvRecord = buffer.substr(sizeBytes, recordSize);
         
         // Create and return the ZipCodeRecord
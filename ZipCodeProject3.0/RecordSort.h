@@ -0,0 +1,226 @@
+/**
+ * @file RecordSort.h
+ * @brief Definition of the RecordSort class, key sorts that return a permutation instead of moving records
+ *
+ * Records are large, and comparing or swapping them costs far more than the
+ * key does. These sorts read each record's key once into a small
+ * (key, index) entry, sort the entries and return the indexes in order;
+ * applyOrder() then moves every record once.
+ *
+ * Integer keys (Zip Codes, curve positions) use an LSD radix sort: one pass
+ * counts every byte digit, then one scatter pass per digit that is not
+ * the same in every key. Each pass reads and writes the entries
+ * sequentially, so the sort runs at memory speed with no comparisons.
+ *
+ * String keys (place names) use a parallel merge sort. Each entry caches the
+ * first 8 bytes of its string as a big-endian integer and its length, so
+ * the characters are only read to order two keys longer than 8 bytes that
+ * start alike. Each thread sorts one slice, and the slices are merged
+ * pairwise, the merges of a round running in parallel.
+ *
+ * Both sorts are stable: equal keys keep their input order.
+ */
+
+#ifndef RECORD_SORT_H
+#define RECORD_SORT_H
+
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <type_traits>
+#include <cstdint>
+
+/**
+ * @class RecordSort
+ * @brief Stable sorts of record keys into index permutations
+ */
+class RecordSort {
+private:
+    static constexpr size_t MIN_SLICE_SIZE = 64 * 1024;  ///< Smaller slices are not worth a thread
+
+    /**
+     * @brief A string key's cached prefix and its record index
+     */
+    struct PrefixEntry {
+        uint64_t prefix;     ///< First 8 bytes of the key, big-endian, zero padded
+        const char* data;    ///< The key's characters
+        uint32_t length;     ///< Key length, capped at UINT32_MAX
+        uint32_t index;      ///< Record index
+    };
+
+    /**
+     * @brief Pack the first 8 bytes of a string so integer order matches string order
+     */
+    static uint64_t prefixOf(std::string_view key) {
+        uint64_t prefix = 0;
+        size_t length = std::min<size_t>(key.size(), 8);
+        for (size_t i = 0; i < length; i++) {
+            prefix |= static_cast<uint64_t>(static_cast<unsigned char>(key[i])) << (56 - 8 * i);
+        }
+        return prefix;
+    }
+
+    /**
+     * @brief Run work(i) for i in [0, count), each on its own thread except the first
+     */
+    template <typename Work>
+    static void runParallel(size_t count, Work work) {
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < count; i++) {
+            workers.emplace_back(work, i);
+        }
+        if (count > 0) {
+            work(0);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+public:
+    /**
+     * @brief Sort unsigned integer keys with an LSD radix sort
+     *
+     * Entries are a key and a 32-bit index, so 32-bit keys such as Zip Codes
+     * move 8 bytes per record and pass; use 64-bit keys only when needed.
+     * @param keys One key per record (uint32_t or uint64_t)
+     * @return Record indexes in ascending key order (input order among equal keys)
+     */
+    template <typename Key>
+    static std::vector<uint32_t> radixOrder(const std::vector<Key>& keys) {
+        static_assert(std::is_unsigned<Key>::value, "radix keys must be unsigned integers");
+        struct Entry {
+            Key key;
+            uint32_t index;
+        };
+        const int DIGITS = sizeof(Key);
+        const size_t count = keys.size();
+        std::vector<Entry> entries(count), scratch(count);
+        std::vector<size_t> histogram(DIGITS * 256, 0);
+        for (uint32_t i = 0; i < count; i++) {
+            entries[i] = {keys[i], i};
+            for (int digit = 0; digit < DIGITS; digit++) {
+                histogram[digit * 256 + ((keys[i] >> (8 * digit)) & 0xFF)]++;
+            }
+        }
+
+        for (int digit = 0; digit < DIGITS; digit++) {
+            size_t* counts = &histogram[digit * 256];
+            if (std::find(counts, counts + 256, count) != counts + 256) {
+                continue;  // Every key has the same byte here, so the pass would not move anything
+            }
+            size_t offset = 0;
+            for (int bucket = 0; bucket < 256; bucket++) {
+                size_t bucketSize = counts[bucket];
+                counts[bucket] = offset;
+                offset += bucketSize;
+            }
+            for (const Entry& entry : entries) {
+                scratch[counts[(entry.key >> (8 * digit)) & 0xFF]++] = entry;
+            }
+            entries.swap(scratch);
+        }
+
+        std::vector<uint32_t> order(count);
+        for (size_t i = 0; i < count; i++) {
+            order[i] = entries[i].index;
+        }
+        return order;
+    }
+
+    /**
+     * @brief Sort string keys with a parallel merge sort on cached prefixes
+     * @param keys One key per record; the strings must stay valid during the call
+     * @param threadCount Number of threads, or 0 to use every hardware thread
+     * @return Record indexes in ascending key order (input order among equal keys)
+     */
+    static std::vector<uint32_t> stringOrder(const std::vector<std::string_view>& keys, unsigned threadCount = 0) {
+        const size_t count = keys.size();
+        std::vector<PrefixEntry> entries(count), scratch(count);
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t length = static_cast<uint32_t>(std::min<size_t>(keys[i].size(), UINT32_MAX));
+            entries[i] = {prefixOf(keys[i]), keys[i].data(), length, i};
+        }
+        // A key no longer than the prefix is a prefix of any other key sharing it, so only longer keys are read
+        auto less = [](const PrefixEntry& a, const PrefixEntry& b) {
+            if (a.prefix != b.prefix) {
+                return a.prefix < b.prefix;
+            }
+            if (a.length > 8 && b.length > 8) {
+                int order = std::string_view(a.data + 8, a.length - 8).compare(std::string_view(b.data + 8, b.length - 8));
+                if (order != 0) {
+                    return order < 0;
+                }
+            } else if (a.length != b.length) {
+                return a.length < b.length;
+            }
+            return a.index < b.index;
+        };
+
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        size_t sliceCount = std::min<size_t>(threadCount, std::max<size_t>(1, count / MIN_SLICE_SIZE));
+        std::vector<size_t> bounds(sliceCount + 1);
+        for (size_t i = 0; i <= sliceCount; i++) {
+            bounds[i] = count * i / sliceCount;
+        }
+        runParallel(sliceCount, [&](size_t s) {
+            std::sort(entries.begin() + bounds[s], entries.begin() + bounds[s + 1], less);
+        });
+
+        // Merge neighbouring slices until one is left
+        while (bounds.size() > 2) {
+            size_t pairs = (bounds.size() - 1) / 2;
+            runParallel(pairs, [&](size_t p) {
+                size_t first = bounds[2 * p], middle = bounds[2 * p + 1], last = bounds[2 * p + 2];
+                std::merge(entries.begin() + first, entries.begin() + middle, entries.begin() + middle,
+                           entries.begin() + last, scratch.begin() + first, less);
+            });
+            if ((bounds.size() - 1) % 2 != 0) {  // An odd slice out is carried over unmerged
+                std::copy(entries.begin() + bounds[bounds.size() - 2], entries.end(),
+                          scratch.begin() + bounds[bounds.size() - 2]);
+            }
+            entries.swap(scratch);
+
+            std::vector<size_t> merged;
+            for (size_t i = 0; i < bounds.size(); i += 2) {
+                merged.push_back(bounds[i]);
+            }
+            if (merged.back() != count) {
+                merged.push_back(count);
+            }
+            bounds.swap(merged);
+        }
+
+        std::vector<uint32_t> order(count);
+        for (size_t i = 0; i < count; i++) {
+            order[i] = entries[i].index;
+        }
+        return order;
+    }
+
+    /**
+     * @brief Rearrange records into a sorted order, moving each record once
+     * @param items The records
+     * @param order Record indexes in the wanted order, as returned by radixOrder() or stringOrder()
+     */
+    template <typename T>
+    static void applyOrder(std::vector<T>& items, const std::vector<uint32_t>& order) {
+        const size_t PREFETCH_DISTANCE = 16;  // Reads are random, so start each one well before it is needed
+        std::vector<T> sorted;
+        sorted.reserve(order.size());
+        for (size_t i = 0; i < order.size(); i++) {
+#if defined(__GNUC__)
+            if (i + PREFETCH_DISTANCE < order.size()) {
+                __builtin_prefetch(&items[order[i + PREFETCH_DISTANCE]]);
+            }
+#endif
+            sorted.push_back(std::move(items[order[i]]));
+        }
+        items.swap(sorted);
+    }
+};
+
+#endif // RECORD_SORT_H
@@ -0,0 +1,114 @@
+/**
+ * @file SortBenchmark.cpp
+ * @brief Compares std::sort on whole records with the RecordSort key sorts.
+ *
+ * Reads a length-indicated file, repeats its records (in shuffled order)
+ * up to the requested count, and sorts copies of them by Zip Code and by
+ * Place Name. Each sort runs twice: once with std::sort on the records, as
+ * the zip processor used to, and once with RecordSort, which sorts the keys
+ * into a permutation and then moves each record once. Times include
+ * extracting the keys and applying the permutation. Both results are
+ * checked to give the same key order.
+ *
+ * Build: g++ -std=c++17 -O2 -pthread -o sort_benchmark SortBenchmark.cpp Buffer.cpp
+ * Usage: ./sort_benchmark [length_file] [records] [threads]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include "Buffer.h"
+#include "RecordSort.h"
+
+using namespace std;
+
+/**
+ * @brief Print one line of the results table
+ */
+void printRow(const string& key, const string& method, double seconds, size_t count) {
+    cout << left << setw(8) << key << setw(12) << method << right << fixed << setprecision(1)
+         << setw(10) << seconds * 1000 << setw(14) << count / seconds / 1e6 << endl;
+}
+
+/**
+ * @brief Time a sort of a fresh copy of the records
+ * @return The sorted copy and, through seconds, the time taken
+ */
+template <typename Sort>
+vector<ZipCodeRecord> timeSort(const vector<ZipCodeRecord>& records, Sort sort, double& seconds) {
+    vector<ZipCodeRecord> copy = records;
+    auto start = chrono::steady_clock::now();
+    sort(copy);
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return copy;
+}
+
+int main(int argc, char* argv[]) {
+    string filename = (argc > 1) ? argv[1] : "us_postal_codes_length.csv";
+    size_t recordCount = (argc > 2) ? stoul(argv[2]) : 1000000;
+    unsigned threads = (argc > 3) ? static_cast<unsigned>(stoul(argv[3])) : 0;
+
+    Buffer buffer;
+    vector<ZipCodeRecord> source;
+    if (!buffer.readLengthIndicatedFile(filename, source) || source.empty()) {
+        cerr << "Error: No records in " << filename << endl;
+        return 1;
+    }
+
+    // Repeat the file's records, shuffled so neither key arrives in order
+    vector<ZipCodeRecord> records;
+    records.reserve(recordCount);
+    while (records.size() < recordCount) {
+        size_t take = min(source.size(), recordCount - records.size());
+        records.insert(records.end(), source.begin(), source.begin() + take);
+    }
+    shuffle(records.begin(), records.end(), mt19937(42));
+
+    cout << "File: " << filename << ", " << records.size() << " records of " << sizeof(ZipCodeRecord)
+         << " bytes" << endl;
+    cout << left << setw(8) << "Key" << setw(12) << "Method" << right << setw(10) << "ms" << setw(14)
+         << "M records/s" << endl;
+
+    double seconds;
+    auto byZip = timeSort(records, [](vector<ZipCodeRecord>& items) {
+        sort(items.begin(), items.end(),
+             [](const ZipCodeRecord& a, const ZipCodeRecord& b) { return a.zip_code < b.zip_code; });
+    }, seconds);
+    printRow("zip", "std::sort", seconds, records.size());
+
+    auto byZipRadix = timeSort(records, [](vector<ZipCodeRecord>& items) {
+        vector<uint32_t> keys(items.size());
+        for (size_t i = 0; i < items.size(); i++) {
+            keys[i] = static_cast<uint32_t>(items[i].zip_code);
+        }
+        RecordSort::applyOrder(items, RecordSort::radixOrder(keys));
+    }, seconds);
+    printRow("zip", "radix", seconds, records.size());
+
+    auto byName = timeSort(records, [](vector<ZipCodeRecord>& items) {
+        sort(items.begin(), items.end(),
+             [](const ZipCodeRecord& a, const ZipCodeRecord& b) { return a.place_name < b.place_name; });
+    }, seconds);
+    printRow("place", "std::sort", seconds, records.size());
+
+    auto byNameMerge = timeSort(records, [threads](vector<ZipCodeRecord>& items) {
+        vector<string_view> keys(items.size());
+        for (size_t i = 0; i < items.size(); i++) {
+            keys[i] = items[i].place_name;
+        }
+        RecordSort::applyOrder(items, RecordSort::stringOrder(keys, threads));
+    }, seconds);
+    printRow("place", "merge", seconds, records.size());
+
+    for (size_t i = 0; i < records.size(); i++) {
+        if (byZip[i].zip_code != byZipRadix[i].zip_code || byName[i].place_name != byNameMerge[i].place_name) {
+            cerr << "Error: Sorted orders differ at record " << i << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -9,6 +9,8 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include <string_view>
+#include "CSVTokenizer.h"
 
 /**
  * @class ZipCodeRecord
@@ -48,27 +50,66 @@ public:
      * @param csvLine A comma-separated string representing the record
      * @return A ZipCodeRecord object
      */
-    static ZipCodeRecord fromCSV(const std::string& csvLine) {
-        std::vector<std::string> parts;
-        std::stringstream ss(csvLine);
-        std::string item;
-        
-        while (std::getline(ss, item, ',')) {
-            parts.push_back(item);
+    static ZipCodeRecord fromCSV(std::string_view csvLine) {
+        ZipCodeRecord record;
+        record.assignCSV(csvLine);
+        return record;
+    }
+
+    /**
+     * @brief Overwrite this record from a comma-separated string
+     *
+     * Reuses the existing string capacity, so parsing into the same record
+     * repeatedly does not allocate once the fields have grown to size.
+     * @param csvLine A comma-separated string representing the record
+     * @return true if the line had at least 6 fields, false otherwise (record is cleared)
+     */
+    bool assignCSV(std::string_view csvLine) {
+        static thread_local CSVTokenizer tokenizer;
+        tokenizer.split(csvLine);
+        return assignFields(tokenizer);
+    }
+
+    /**
+     * @brief Overwrite this record from already-split CSV fields
+     * @param fields Field source with size() and operator[] (CSVTokenizer or CSVBulkReader)
+     * @return true if there were at least 6 fields, false otherwise (record is cleared)
+     */
+    template <typename Fields>
+    bool assignFields(const Fields& fields) {
+        if (fields.size() < 6) {
+            *this = ZipCodeRecord(); // Empty record if parsing fails
+            return false;
         }
         
-        if (parts.size() >= 6) {
-            double lat = 0.0, lon = 0.0;
-            try {
-                lat = std::stod(parts[4]);
-                lon = std::stod(parts[5]);
-            } catch (...) {
-                // Handle conversion errors
-            }
-            return ZipCodeRecord(parts[0], parts[1], parts[2], parts[3], lat, lon);
-        }
+        zipCode.assign(fields[0]);
+        cityName.assign(fields[1]);
+        stateName.assign(fields[2]);
+        countyName.assign(fields[3]);
         
-        return ZipCodeRecord(); // Return an empty record if parsing fails
+        // Unparseable coordinates default to 0.0
+        if (!CSVTokenizer::parseDouble(fields[4], latitude)) latitude = 0.0;
+        if (!CSVTokenizer::parseDouble(fields[5], longitude)) longitude = 0.0;
+        return true;
+    }
+
+    /**
+     * @brief Overwrite every field, reusing the existing string capacity
+     * @param zip The Zip Code
+     * @param city The city name
+     * @param state The state name
+     * @param county The county name
+     * @param lat The latitude
+     * @param lon The longitude
+     */
+    void assign(std::string_view zip, std::string_view city, std::string_view state,
+                std::string_view county, double lat, double lon) {
+        zipCode.assign(zip);
+        cityName.assign(city);
+        stateName.assign(state);
+        countyName.assign(county);
+        latitude = lat;
+        longitude = lon;
     }
 
     /**
@@ -86,25 +127,25 @@ public:
      * @brief Get the Zip Code (primary key)
      * @return The Zip Code
      */
-    std::string getZipCode() const { return zipCode; }
+    const std::string& getZipCode() const { return zipCode; }
 
     /**
      * @brief Get the city name
      * @return The city name
      */
-    std::string getCityName() const { return cityName; }
+    const std::string& getCityName() const { return cityName; }
 
     /**
      * @brief Get the state name
      * @return The state name
      */
-    std::string getStateName() const { return stateName; }
+    const std::string& getStateName() const { return stateName; }
 
     /**
      * @brief Get the county name
      * @return The county name
      */
-    std::string getCountyName() const { return countyName; }
+    const std::string& getCountyName() const { return countyName; }
 
     /**
      * @brief Get the latitude
@@ -0,0 +1,458 @@
+/**
+ * @file ZipGeoIndex.h
+ * @brief Definition of the ZipGeoIndex class, a Z-order secondary index for box and radius queries
+ *
+ * Latitude and longitude are quantized to 32 bits each and their bits are
+ * interleaved (longitude first, as in a geohash) into one 64-bit Z-order
+ * key. Points close on the map mostly have close keys, and every quadtree
+ * cell of the map is one contiguous key range. A box query is cut into a
+ * bounded number of cells, so it becomes a few binary searches and short
+ * scans of the sorted entries; an exact coordinate (or distance) test then
+ * drops the points that lie in a cell but outside the query.
+ *
+ * Entries are stored sorted by key in a flat file that is memory-mapped and
+ * searched in place.
+ */
+
+#ifndef ZIP_GEO_INDEX_H
+#define ZIP_GEO_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "MappedFile.h"
+#include "LittleEndian.h"
+#include "ZipDistances.h"
+
+/**
+ * @class ZipGeoIndex
+ * @brief Zip Code points sorted by Z-order key, with their block RBNs
+ */
+class ZipGeoIndex {
+public:
+    static constexpr size_t MAX_ZIP_LENGTH = 8;           ///< Longest Zip Code key stored
+    static constexpr size_t DEFAULT_MAX_RANGES = 32;      ///< Key ranges a query is cut into, at most
+
+    /**
+     * @brief One query result
+     */
+    struct Match {
+        std::string zipCode;  ///< Zip Code of the point
+        int rbn;              ///< RBN of the block holding the record
+        double latitude;      ///< Latitude in degrees
+        double longitude;     ///< Longitude in degrees
+        double distanceKm;    ///< Great-circle distance from the query centre (radius queries only)
+    };
+
+private:
+    /**
+     * @brief One indexed point
+     */
+    struct Entry {
+        uint64_t key;               ///< Z-order key of the quantized coordinates
+        double latitude;            ///< Latitude in degrees
+        double longitude;           ///< Longitude in degrees
+        int32_t rbn;                ///< RBN of the block holding the record
+        char zip[MAX_ZIP_LENGTH];   ///< Zip Code, zero padded
+    };
+
+    /**
+     * @brief A quantized box: inclusive cell coordinate ranges
+     */
+    struct CellBox {
+        uint32_t minX, maxX;  ///< Longitude cells
+        uint32_t minY, maxY;  ///< Latitude cells
+    };
+
+    using KeyRange = std::pair<uint64_t, uint64_t>;  ///< Inclusive key range
+
+    static constexpr char MAGIC[8] = {'Z', 'I', 'P', 'G', 'E', 'O', 'Z', 'O'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 24;  ///< magic, version, entry size, entry count
+    static constexpr size_t ENTRY_SIZE = 40;   ///< key, latitude, longitude, rbn, zip, 4 pad bytes
+    static constexpr int LEVELS = 32;          ///< Bits per coordinate
+
+    MappedFile mapped;            ///< Index file, read in place after load()
+    std::vector<Entry> entries;   ///< Entries of an index built in memory (empty after load())
+    uint64_t entryCount;          ///< Number of points
+
+    /**
+     * @brief Get the key of an entry from memory or from the mapped file
+     */
+    uint64_t keyAt(size_t position) const {
+        if (!entries.empty()) {
+            return entries[position].key;
+        }
+        return getLE(mapped.data() + HEADER_SIZE + position * ENTRY_SIZE, 8);
+    }
+
+    /**
+     * @brief Get an entry from memory or from the mapped file
+     */
+    Entry entryAt(size_t position) const {
+        if (!entries.empty()) {
+            return entries[position];
+        }
+        Entry entry;
+        const char* in = mapped.data() + HEADER_SIZE + position * ENTRY_SIZE;
+        entry.key = getLE(in, 8);
+        entry.latitude = getDoubleLE(in + 8);
+        entry.longitude = getDoubleLE(in + 16);
+        entry.rbn = static_cast<int32_t>(getLE(in + 24, 4));
+        std::memcpy(entry.zip, in + 28, MAX_ZIP_LENGTH);
+        return entry;
+    }
+
+    /**
+     * @brief Spread the low 32 bits of a value to the even bit positions
+     */
+    static uint64_t spreadBits(uint32_t value) {
+        uint64_t bits = value;
+        bits = (bits | (bits << 16)) & 0x0000FFFF0000FFFFULL;
+        bits = (bits | (bits << 8)) & 0x00FF00FF00FF00FFULL;
+        bits = (bits | (bits << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        bits = (bits | (bits << 2)) & 0x3333333333333333ULL;
+        bits = (bits | (bits << 1)) & 0x5555555555555555ULL;
+        return bits;
+    }
+
+    /**
+     * @brief Quantize a longitude to a 32-bit cell coordinate
+     */
+    static uint32_t toCellX(double longitude) {
+        double scaled = (std::clamp(longitude, -180.0, 180.0) + 180.0) / 360.0 * 4294967296.0;
+        return static_cast<uint32_t>(std::min(scaled, 4294967295.0));
+    }
+
+    /**
+     * @brief Quantize a latitude to a 32-bit cell coordinate
+     */
+    static uint32_t toCellY(double latitude) {
+        double scaled = (std::clamp(latitude, -90.0, 90.0) + 90.0) / 180.0 * 4294967296.0;
+        return static_cast<uint32_t>(std::min(scaled, 4294967295.0));
+    }
+
+    /**
+     * @brief Cut a quantized box into at most maxRanges key ranges that cover it
+     *
+     * The quadtree is refined one level at a time. Cells inside the box are
+     * kept whole; cells crossing its edge are split until splitting them all
+     * would exceed the budget, and are then kept whole too (the exact test
+     * removes their outside points). Adjacent ranges are merged.
+     */
+    static std::vector<KeyRange> coverBox(const CellBox& box, size_t maxRanges) {
+        struct Cell {
+            uint32_t x, y;  ///< Cell coordinates at the current level
+        };
+        std::vector<KeyRange> ranges;
+        std::vector<Cell> partial{{0, 0}};
+        int level = 0;
+
+        auto cellRange = [](const Cell& cell, int cellLevel) {
+            if (cellLevel == 0) {
+                return KeyRange(0, UINT64_MAX);
+            }
+            int shift = 2 * (LEVELS - cellLevel);
+            uint64_t prefix = ((spreadBits(cell.x) << 1) | spreadBits(cell.y)) << shift;
+            return KeyRange(prefix, prefix + ((uint64_t(1) << shift) - 1));
+        };
+
+        while (!partial.empty() && level < LEVELS && ranges.size() + partial.size() * 4 <= maxRanges) {
+            std::vector<Cell> next;
+            int shift = LEVELS - (level + 1);
+            for (const Cell& cell : partial) {
+                for (uint32_t child = 0; child < 4; child++) {
+                    Cell c{(cell.x << 1) | (child >> 1), (cell.y << 1) | (child & 1)};
+                    uint64_t lowX = uint64_t(c.x) << shift, highX = ((uint64_t(c.x) + 1) << shift) - 1;
+                    uint64_t lowY = uint64_t(c.y) << shift, highY = ((uint64_t(c.y) + 1) << shift) - 1;
+                    if (highX < box.minX || lowX > box.maxX || highY < box.minY || lowY > box.maxY) {
+                        continue;
+                    }
+                    if (lowX >= box.minX && highX <= box.maxX && lowY >= box.minY && highY <= box.maxY) {
+                        ranges.push_back(cellRange(c, level + 1));
+                    } else {
+                        next.push_back(c);
+                    }
+                }
+            }
+            partial.swap(next);
+            level++;
+        }
+        for (const Cell& cell : partial) {
+            ranges.push_back(cellRange(cell, level));
+        }
+
+        std::sort(ranges.begin(), ranges.end());
+        std::vector<KeyRange> merged;
+        for (const KeyRange& range : ranges) {
+            if (!merged.empty() && merged.back().second != UINT64_MAX && range.first <= merged.back().second + 1) {
+                merged.back().second = std::max(merged.back().second, range.second);
+            } else {
+                merged.push_back(range);
+            }
+        }
+        return merged;
+    }
+
+    /**
+     * @brief Collect the entries inside a box that does not cross the date line
+     * @param accept Exact test on an entry; fills the distance of radius queries
+     */
+    template <typename Accept>
+    void scanBox(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude,
+                 size_t maxRanges, Accept accept, std::vector<Match>& results) const {
+        CellBox box{toCellX(minLongitude), toCellX(maxLongitude), toCellY(minLatitude), toCellY(maxLatitude)};
+        for (const KeyRange& range : coverBox(box, maxRanges)) {
+            size_t low = 0, high = entryCount;
+            while (low < high) {
+                size_t middle = low + (high - low) / 2;
+                if (keyAt(middle) < range.first) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            for (size_t position = low; position < entryCount && keyAt(position) <= range.second; position++) {
+                Entry entry = entryAt(position);
+                if (entry.latitude < minLatitude || entry.latitude > maxLatitude ||
+                    entry.longitude < minLongitude || entry.longitude > maxLongitude) {
+                    continue;
+                }
+                Match match{std::string(entry.zip, strnlen(entry.zip, MAX_ZIP_LENGTH)), entry.rbn,
+                            entry.latitude, entry.longitude, 0.0};
+                if (accept(match)) {
+                    results.push_back(std::move(match));
+                }
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Constructor (empty index)
+     */
+    ZipGeoIndex() : entryCount(0) {}
+
+    ZipGeoIndex(const ZipGeoIndex&) = delete;
+    ZipGeoIndex& operator=(const ZipGeoIndex&) = delete;
+
+    /**
+     * @brief Get the Z-order key of a location
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     * @return The 64-bit key (longitude bits in the odd positions)
+     */
+    static uint64_t zOrderKey(double latitude, double longitude) {
+        return (spreadBits(toCellX(longitude)) << 1) | spreadBits(toCellY(latitude));
+    }
+
+    /**
+     * @brief Get the position of a location along a Hilbert curve over the map
+     *
+     * Unlike the Z-order key, consecutive Hilbert positions are always
+     * adjacent cells, so sorting by it keeps neighbours together without
+     * Z-order's long jumps at cell boundaries.
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     * @return The 64-bit curve position of the quantized location
+     */
+    static uint64_t hilbertKey(double latitude, double longitude) {
+        uint32_t x = toCellX(longitude);
+        uint32_t y = toCellY(latitude);
+        uint64_t key = 0;
+        for (uint32_t bit = uint32_t(1) << (LEVELS - 1); bit > 0; bit >>= 1) {
+            uint32_t rx = (x & bit) ? 1 : 0;
+            uint32_t ry = (y & bit) ? 1 : 0;
+            key += uint64_t(bit) * bit * ((3 * rx) ^ ry);
+            // Rotate the quadrant so the curve stays continuous
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = ~x;
+                    y = ~y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return key;
+    }
+
+    /**
+     * @brief Start building a new index (discards any loaded index)
+     */
+    void clear() {
+        mapped.close();
+        entries.clear();
+        entryCount = 0;
+    }
+
+    /**
+     * @brief Add a point to an index being built
+     * @param zipCode Zip Code of the record (longer keys are not indexed)
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     * @param rbn RBN of the block holding the record
+     * @return true if added, false if the Zip Code is too long to store
+     */
+    bool add(std::string_view zipCode, double latitude, double longitude, int rbn) {
+        if (zipCode.empty() || zipCode.size() > MAX_ZIP_LENGTH) {
+            return false;
+        }
+        Entry entry{};
+        entry.key = zOrderKey(latitude, longitude);
+        entry.latitude = latitude;
+        entry.longitude = longitude;
+        entry.rbn = rbn;
+        std::memcpy(entry.zip, zipCode.data(), zipCode.size());
+        entries.push_back(entry);
+        entryCount = entries.size();
+        return true;
+    }
+
+    /**
+     * @brief Sort the added points by key; call once after the last add()
+     */
+    void build() {
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+    }
+
+    /**
+     * @brief Write the index to a file
+     * @param fileName Name of the index file
+     * @return true if successful, false otherwise
+     */
+    bool save(const std::string& fileName) const {
+        std::string data(HEADER_SIZE + entryCount * ENTRY_SIZE, '\0');
+        data.replace(0, sizeof(MAGIC), MAGIC, sizeof(MAGIC));
+        putLE(&data[8], VERSION, 4);
+        putLE(&data[12], ENTRY_SIZE, 4);
+        putLE(&data[16], entryCount, 8);
+        for (size_t position = 0; position < entryCount; position++) {
+            Entry entry = entryAt(position);
+            char* out = &data[HEADER_SIZE + position * ENTRY_SIZE];
+            putLE(out, entry.key, 8);
+            putDoubleLE(out + 8, entry.latitude);
+            putDoubleLE(out + 16, entry.longitude);
+            putLE(out + 24, static_cast<uint32_t>(entry.rbn), 4);
+            std::memcpy(out + 28, entry.zip, MAX_ZIP_LENGTH);
+        }
+
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        return file.is_open() && file.write(data.data(), data.size());
+    }
+
+    /**
+     * @brief Map an index file for searching
+     * @param fileName Name of the index file
+     * @return true if successful, false if the file is missing or not a valid index
+     */
+    bool load(const std::string& fileName) {
+        clear();
+        if (!mapped.open(fileName)) {
+            return false;
+        }
+        const char* data = mapped.data();
+        if (mapped.size() < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 ||
+            getLE(data + 8, 4) != VERSION || getLE(data + 12, 4) != ENTRY_SIZE ||
+            (mapped.size() - HEADER_SIZE) / ENTRY_SIZE != getLE(data + 16, 8)) {
+            mapped.close();
+            return false;
+        }
+        entryCount = getLE(data + 16, 8);
+        return true;
+    }
+
+    /**
+     * @brief Find the points inside a latitude/longitude box
+     * @param minLatitude Southern edge in degrees
+     * @param minLongitude Western edge in degrees (greater than maxLongitude if the box crosses the date line)
+     * @param maxLatitude Northern edge in degrees
+     * @param maxLongitude Eastern edge in degrees
+     * @param maxRanges Key ranges the box may be cut into
+     * @return The points in the box, in key order
+     */
+    std::vector<Match> withinBox(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude,
+                                 size_t maxRanges = DEFAULT_MAX_RANGES) const {
+        std::vector<Match> results;
+        if (entryCount == 0 || minLatitude > maxLatitude) {
+            return results;
+        }
+        auto any = [](Match&) { return true; };
+        if (minLongitude > maxLongitude) {
+            scanBox(minLatitude, minLongitude, maxLatitude, 180.0, maxRanges, any, results);
+            scanBox(minLatitude, -180.0, maxLatitude, maxLongitude, maxRanges, any, results);
+        } else {
+            scanBox(minLatitude, minLongitude, maxLatitude, maxLongitude, maxRanges, any, results);
+        }
+        return results;
+    }
+
+    /**
+     * @brief Find the points within a great-circle distance of a location
+     *
+     * The circle's bounding box is searched (split at the date line, and
+     * widened to every longitude if the circle covers a pole), and each
+     * candidate's distance is checked exactly.
+     * @param latitude Latitude of the centre in degrees
+     * @param longitude Longitude of the centre in degrees
+     * @param radiusKm Radius in km
+     * @param maxRanges Key ranges the bounding box may be cut into
+     * @return The points within the radius, nearest first
+     */
+    std::vector<Match> withinRadius(double latitude, double longitude, double radiusKm,
+                                    size_t maxRanges = DEFAULT_MAX_RANGES) const {
+        std::vector<Match> results;
+        if (entryCount == 0 || radiusKm < 0) {
+            return results;
+        }
+        const double degrees = 180.0 / M_PI;
+        double angle = radiusKm / ZipDistances::EARTH_RADIUS_KM;
+        double minLatitude = latitude - angle * degrees;
+        double maxLatitude = latitude + angle * degrees;
+        double minLongitude = -180.0, maxLongitude = 180.0;
+        if (minLatitude > -90.0 && maxLatitude < 90.0 && angle < M_PI / 2) {
+            double spread = std::asin(std::min(1.0, std::sin(angle) / std::cos(latitude * M_PI / 180.0))) * degrees;
+            minLongitude = longitude - spread;
+            maxLongitude = longitude + spread;
+        }
+
+        auto inside = [&](Match& match) {
+            match.distanceKm = ZipDistances::distanceKm(latitude, longitude, match.latitude, match.longitude);
+            return match.distanceKm <= radiusKm;
+        };
+        minLatitude = std::max(minLatitude, -90.0);
+        maxLatitude = std::min(maxLatitude, 90.0);
+        if (minLongitude < -180.0) {
+            scanBox(minLatitude, minLongitude + 360.0, maxLatitude, 180.0, maxRanges, inside, results);
+            scanBox(minLatitude, -180.0, maxLatitude, maxLongitude, maxRanges, inside, results);
+        } else if (maxLongitude > 180.0) {
+            scanBox(minLatitude, minLongitude, maxLatitude, 180.0, maxRanges, inside, results);
+            scanBox(minLatitude, -180.0, maxLatitude, maxLongitude - 360.0, maxRanges, inside, results);
+        } else {
+            scanBox(minLatitude, minLongitude, maxLatitude, maxLongitude, maxRanges, inside, results);
+        }
+
+        std::sort(results.begin(), results.end(),
+                  [](const Match& a, const Match& b) { return a.distanceKm < b.distanceKm; });
+        return results;
+    }
+
+    /**
+     * @brief Get the number of points in the index
+     * @return The point count
+     */
+    uint64_t size() const { return entryCount; }
+
+    /**
+     * @brief Check if the index is available for searching
+     * @return true after load() or build()
+     */
+    bool isOpen() const { return !entries.empty() || mapped.isOpen(); }
+};
+
+#endif // ZIP_GEO_INDEX_H
@@ -1,57 +1,228 @@
 #include "ZipIndex.h"
+#include "CSVTokenizer.h"
+#include "MappedFile.h"
+#include "LittleEndian.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <thread>
 
 using namespace std;
 
+// Binary index layout (little-endian): 32-byte header, then binaryCount packed entries
+static const char BINARY_INDEX_MAGIC[8] = {'Z', 'I', 'P', 'I', 'N', 'D', 'E', 'X'};
+static const uint32_t BINARY_INDEX_VERSION = 1;
+static const size_t BINARY_INDEX_HEADER_SIZE = 32; // magic, version, entry size, count, checksum
+static const size_t BINARY_INDEX_ENTRY_SIZE = 12;  // uint32 zip + uint64 offset
+
+// Sparse index: same layout, one entry per page plus an end-of-data sentinel entry
+static const char SPARSE_INDEX_MAGIC[8] = {'Z', 'I', 'P', 'S', 'P', 'A', 'R', 'S'};
+static const uint32_t SPARSE_SENTINEL_ZIP = 0xFFFFFFFF;
+
+// Learned index: same layout, with a LearnedIndex model of the entries after the last entry
+static const char LEARNED_INDEX_MAGIC[8] = {'Z', 'I', 'P', 'L', 'E', 'A', 'R', 'N'};
+
+/**
+ * @brief 64-bit FNV-1a checksum of the packed entries.
+ */
+static uint64_t checksumEntries(const char* data, size_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Converts a Zip Code of up to 5 digits to its integer key.
+ * @return true if the Zip Code is numeric, false otherwise.
+ */
+static bool parseZipKey(const string& zipCode, uint32_t& key) {
+    if (zipCode.empty() || zipCode.length() > 5) {
+        return false;
+    }
+    auto result = from_chars(zipCode.data(), zipCode.data() + zipCode.size(), key);
+    return result.ec == errc() && result.ptr == zipCode.data() + zipCode.size();
+}
+
+/**
+ * @brief Writes sorted entries as a binary index file.
+ * @param withModel Whether to fit a LearnedIndex to the entries and store it after them.
+ * @return true if successful, false otherwise.
+ */
+static bool writeBinaryIndex(const string& indexFilename, const vector<ZipIndex::Entry>& entries,
+                             const char* magic = BINARY_INDEX_MAGIC, bool withModel = false) {
+    size_t entriesSize = entries.size() * BINARY_INDEX_ENTRY_SIZE;
+    string data(BINARY_INDEX_HEADER_SIZE + entriesSize, '\0');
+    char* out = &data[BINARY_INDEX_HEADER_SIZE];
+    for (const auto& entry : entries) {
+        putLE(out, entry.zip, 4);
+        putLE(out + 4, entry.offset, 8);
+        out += BINARY_INDEX_ENTRY_SIZE;
+    }
+
+    const char* fileMagic = withModel ? LEARNED_INDEX_MAGIC : magic;
+    copy(fileMagic, fileMagic + 8, data.begin());
+    putLE(&data[8], BINARY_INDEX_VERSION, 4);
+    putLE(&data[12], BINARY_INDEX_ENTRY_SIZE, 4);
+    putLE(&data[16], entries.size(), 8);
+    putLE(&data[24], checksumEntries(data.data() + BINARY_INDEX_HEADER_SIZE, entriesSize), 8);
+
+    if (withModel) {
+        LearnedIndex model;
+        model.fit(entries.size(), [&](size_t i) { return static_cast<uint64_t>(entries[i].zip); });
+        model.serialize(data);
+    }
+
+    ofstream file(indexFilename, ios::binary | ios::trunc);
+    if (!file) {
+        cerr << " Error opening index file: " << indexFilename << endl;
+        return false;
+    }
+    file.write(data.data(), data.size());
+    file.close();
+    if (!file) {
+        cerr << " Error writing index file: " << indexFilename << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Parses the length prefix of the record starting at pos.
+ * @return The offset of the next record, or 0 if pos does not start a
+ *         well-formed "length,payload\n" record.
+ */
+static size_t nextRecordOffset(const char* data, size_t size, size_t pos, size_t& payload) {
+    size_t length = 0;
+    size_t p = pos;
+    while (p < size && p - pos < 6 && data[p] >= '0' && data[p] <= '9') {
+        length = length * 10 + (data[p] - '0');
+        p++;
+    }
+    if (p == pos || p >= size || data[p] != ',') {
+        return 0;
+    }
+    payload = p + 1;
+
+    size_t end = payload + length;
+    if (end < size && data[end] == '\r') {
+        end++;
+    }
+    if (end < size && data[end] == '\n') {
+        return end + 1;
+    }
+    return end == size ? end : 0;
+}
+
+/**
+ * @brief Parses the Zip Code, the first payload field of 1 to 5 digits, of a record.
+ * @return true if the Zip Code is valid, false otherwise.
+ */
+static bool parseRecordZip(const char* data, size_t payload, size_t next, uint32_t& zip) {
+    zip = 0;
+    size_t p = payload;
+    while (p < next && data[p] >= '0' && data[p] <= '9' && p - payload < 6) {
+        zip = zip * 10 + (data[p] - '0');
+        p++;
+    }
+    return p > payload && p - payload <= 5 && (p == next || data[p] == ',' || data[p] == '\r' || data[p] == '\n');
+}
+
+/**
+ * @brief Finds the first record at or after pos (the start of a line whose length prefix checks out).
+ * @return The record offset, or end if there is none before end.
+ */
+static size_t alignToRecord(const char* data, size_t size, size_t pos, size_t end) {
+    size_t payload;
+    if (pos > 0 && data[pos - 1] != '\n') {
+        const void* newline = memchr(data + pos, '\n', end - pos);
+        pos = newline ? static_cast<const char*>(newline) - data + 1 : end;
+    }
+    while (pos < end && nextRecordOffset(data, size, pos, payload) == 0) {
+        const void* newline = memchr(data + pos, '\n', end - pos);
+        pos = newline ? static_cast<const char*>(newline) - data + 1 : end;
+    }
+    return pos;
+}
+
+/**
+ * @brief Finds where the records start, after the header written by HeaderBuffer
+ *        (8 fixed lines, one line per field, then the primary key line).
+ * @return The offset of the first record, or 0 if the header is not recognized.
+ */
+static size_t findFirstRecord(const char* data, size_t size) {
+    CSVLineReader reader(data, size);
+    string_view line;
+    for (int i = 0; i < 8; i++) {
+        if (!reader.nextLine(line)) {
+            return 0;
+        }
+    }
+    long fieldCount;
+    if (!CSVTokenizer::parseInt(line, fieldCount) || fieldCount < 0) {
+        return 0;
+    }
+    for (long i = 0; i <= fieldCount; i++) {
+        if (!reader.nextLine(line)) {
+            return 0;
+        }
+    }
+    return reader.getOffset();
+}
+
+/**
+ * @brief Sets how much buildIndex and buildBinaryIndex print.
+ * @param level 0 for errors only, 1 for summaries (the default), 2 to also list every indexed Zip Code.
+ */
+void ZipIndex::setVerbosity(int level) {
+    verbosity = level;
+}
+
 /**
  * @brief Builds the index from a length-indicated file.
  * @param filename The file containing length-indicated Zip Code records.
  */
 void ZipIndex::buildIndex(const string& filename) {
-    ifstream file(filename);
-    if (!file.is_open()) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
         cerr << " Error opening file: " << filename << endl;
         return;
     }
 
     index.clear();
-    string line;
+    CSVLineReader reader(file.data(), file.size());
+    CSVTokenizer tokenizer;
+    string_view line;
 
     // Skip header
-    if (!getline(file, line)) {
+    if (!reader.nextLine(line)) {
         cerr << "Error: CSV file is empty or not formatted correctly!" << endl;
         return;
     }
-    cout << " Skipping header: " << line << endl;
-
-    // Store the current file position (beginning of data)
-    long offset = file.tellg();
+    if (verbosity >= 1) {
+        cout << " Skipping header: " << line << endl;
+    }
 
-    while (getline(file, line)) {
+    string zipCode;
+    while (reader.nextLine(line)) {
         if (line.empty()) continue; // Ignore empty lines
 
-        // Store current offset for this line
-        long currentOffset = offset;
-        
-        // Update offset for next line
-        offset = file.tellg();
+        // Offset of the start of this line
+        long currentOffset = reader.getLineOffset();
 
-        stringstream ss(line);
-        string recordLength, zipCode;
-
-        //  Skip the first column (record length)
-        if (!getline(ss, recordLength, ',')) continue;
-        
-        // ✅ Extract the second column (actual Zip Code)
-        if (!getline(ss, zipCode, ',')) continue;
+        //  Skip the first column (record length), the second is the actual Zip Code
+        if (tokenizer.split(line) < 2) continue;
+        string_view zipField = tokenizer[1];
 
         // ✅ Ensure zip code is stored as exactly 5 digits
-        while (zipCode.length() < 5) {
-            zipCode = "0" + zipCode;
-        }
+        zipCode.assign(zipField.size() < 5 ? 5 - zipField.size() : 0, '0');
+        zipCode.append(zipField);
 
         // ✅ Validate Zip Code (must be numeric and 5 digits long)
         if (zipCode.length() != 5 || zipCode.find_first_not_of("0123456789") != string::npos) {
@@ -61,11 +232,223 @@ void ZipIndex::buildIndex(const string& filename) {
 
         // ✅ Store offset for this Zip Code
         index[zipCode] = currentOffset;
-        cout << "✅ Indexed Zip Code: " << zipCode << " at offset " << currentOffset << endl;
+        if (verbosity >= 2) {
+            cout << "✅ Indexed Zip Code: " << zipCode << " at offset " << currentOffset << endl;
+        }
     }
 
-    file.close();
-    cout << "✅ Indexing complete. Total entries: " << index.size() << endl;
+    if (verbosity >= 1) {
+        cout << "✅ Indexing complete. Total entries: " << index.size() << endl;
+    }
+}
+
+/**
+ * @brief Builds a binary index straight from a length-indicated file, without the map.
+ *
+ * Records are found by jumping from one length prefix to the next rather
+ * than by reading lines. The file is split into one byte range per thread,
+ * each starting at a record boundary; every thread collects and sorts its
+ * own entries, and the sorted ranges are merged into the index. If the file
+ * does not have the length-indicated layout, this falls back to buildIndex.
+ * @param filename The file containing length-indicated Zip Code records.
+ * @param indexFilename The output index file.
+ * @param threadCount Number of threads, or 0 to use every hardware thread.
+ * @return true if successful, false otherwise.
+ */
+bool ZipIndex::buildBinaryIndex(const string& filename, const string& indexFilename, unsigned threadCount,
+                                bool withModel) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        cerr << " Error opening file: " << filename << endl;
+        return false;
+    }
+    const char* data = file.data();
+    size_t size = file.size();
+
+    size_t start = findFirstRecord(data, size);
+    size_t payload;
+    if (start == 0 || (start < size && nextRecordOffset(data, size, start, payload) == 0)) {
+        if (verbosity >= 1) {
+            cout << " Not a length-indicated file, indexing line by line" << endl;
+        }
+        buildIndex(filename);
+        return saveBinaryIndex(indexFilename, withModel);
+    }
+
+    // Small ranges are not worth a thread
+    const size_t MIN_RANGE_SIZE = 256 * 1024;
+    if (threadCount == 0) {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+    size_t rangeCount = min<size_t>(threadCount, max<size_t>(1, (size - start) / MIN_RANGE_SIZE));
+
+    vector<size_t> bounds(rangeCount + 1, size);
+    bounds[0] = start;
+    for (size_t i = 1; i < rangeCount; i++) {
+        bounds[i] = alignToRecord(data, size, max(bounds[i - 1], start + (size - start) * i / rangeCount), size);
+    }
+
+    vector<vector<Entry>> ranges(rangeCount);
+    vector<size_t> skipped(rangeCount, 0);
+    vector<char> corrupt(rangeCount, 0);
+    auto scanRange = [&](size_t r) {
+        vector<Entry>& entries = ranges[r];
+        entries.reserve((bounds[r + 1] - bounds[r]) / 40);
+        size_t pos = bounds[r];
+        while (pos < bounds[r + 1]) {
+            size_t recordPayload;
+            size_t next = nextRecordOffset(data, size, pos, recordPayload);
+            if (next == 0) {
+                corrupt[r] = 1;
+                return;
+            }
+
+            uint32_t zip;
+            if (!parseRecordZip(data, recordPayload, next, zip)) {
+                skipped[r]++;
+            } else {
+                entries.push_back({zip, pos});
+            }
+            pos = next;
+        }
+        // Stable, so the last record wins among duplicate Zip Codes, as in buildIndex
+        stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.zip < b.zip; });
+    };
+
+    vector<thread> workers;
+    for (size_t r = 1; r < rangeCount; r++) {
+        workers.emplace_back(scanRange, r);
+    }
+    scanRange(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    if (find(corrupt.begin(), corrupt.end(), 1) != corrupt.end()) {
+        cerr << " Warning: Malformed length prefix in " << filename << ", indexing line by line" << endl;
+        buildIndex(filename);
+        return saveBinaryIndex(indexFilename, withModel);
+    }
+
+    // Merge the sorted ranges in file order, then keep the last entry of each Zip Code
+    vector<Entry> entries = move(ranges[0]);
+    for (size_t r = 1; r < rangeCount; r++) {
+        size_t middle = entries.size();
+        entries.insert(entries.end(), ranges[r].begin(), ranges[r].end());
+        vector<Entry>().swap(ranges[r]);
+        inplace_merge(entries.begin(), entries.begin() + middle, entries.end(),
+                      [](const Entry& a, const Entry& b) { return a.zip < b.zip; });
+    }
+    size_t unique = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (i + 1 < entries.size() && entries[i + 1].zip == entries[i].zip) {
+            continue;
+        }
+        entries[unique++] = entries[i];
+    }
+    entries.resize(unique);
+
+    size_t skippedTotal = 0;
+    for (size_t count : skipped) {
+        skippedTotal += count;
+    }
+    if (skippedTotal > 0) {
+        cerr << " Warning: Skipped " << skippedTotal << " records with an invalid zip code" << endl;
+    }
+    if (verbosity >= 2) {
+        for (const auto& entry : entries) {
+            cout << "✅ Indexed Zip Code: " << setw(5) << setfill('0') << entry.zip << setfill(' ')
+                 << " at offset " << entry.offset << endl;
+        }
+    }
+
+    if (!writeBinaryIndex(indexFilename, entries, BINARY_INDEX_MAGIC, withModel)) {
+        return false;
+    }
+    if (verbosity >= 1) {
+        cout << "✅ Indexing complete. Total entries: " << entries.size() << " (" << rangeCount
+             << (rangeCount == 1 ? " thread)" : " threads)") << endl;
+        cout << (withModel ? "Learned" : "Binary") << " index successfully saved to " << indexFilename << endl;
+    }
+    return true;
+}
+
+/**
+ * @brief Builds a sparse index of a length-indicated file sorted by Zip Code.
+ *
+ * Records are grouped into pages of about pageSize bytes, and the index
+ * keeps only the first Zip Code and offset of each page, so it is roughly
+ * pageSize / (record size * 12 bytes) times smaller than the full index.
+ * findRecord binary-searches the pages and reads and scans one page.
+ * @param filename The length-indicated file, sorted by Zip Code.
+ * @param indexFilename The output index file.
+ * @param pageSize Approximate number of data bytes covered by each entry.
+ * @return true if successful, false if the file is unsorted or not length-indicated.
+ */
+bool ZipIndex::buildSparseIndex(const string& filename, const string& indexFilename, size_t pageSize) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        cerr << " Error opening file: " << filename << endl;
+        return false;
+    }
+    const char* data = file.data();
+    size_t size = file.size();
+
+    size_t pos = findFirstRecord(data, size);
+    if (pos == 0) {
+        cerr << " Error: " << filename << " is not a length-indicated file" << endl;
+        return false;
+    }
+
+    vector<Entry> entries;
+    entries.reserve(size / max<size_t>(pageSize, 1) + 2);
+    uint32_t previousZip = 0;
+    bool first = true;
+    size_t skippedTotal = 0;
+    while (pos < size) {
+        size_t payload;
+        size_t next = nextRecordOffset(data, size, pos, payload);
+        if (next == 0) {
+            cerr << " Error: Malformed length prefix at offset " << pos << " in " << filename << endl;
+            return false;
+        }
+
+        uint32_t zip;
+        if (!parseRecordZip(data, payload, next, zip)) {
+            skippedTotal++;
+        } else {
+            if (!first && zip < previousZip) {
+                cerr << " Error: " << filename << " is not sorted by Zip Code (" << zip << " follows "
+                     << previousZip << "), a sparse index needs a sorted file" << endl;
+                return false;
+            }
+            // Start a new page once the current one covers pageSize bytes
+            if (first || pos >= entries.back().offset + pageSize) {
+                entries.push_back({zip, pos});
+                if (verbosity >= 2) {
+                    cout << "✅ Indexed page starting at Zip Code: " << setw(5) << setfill('0') << zip
+                         << setfill(' ') << " at offset " << pos << endl;
+                }
+            }
+            previousZip = zip;
+            first = false;
+        }
+        pos = next;
+    }
+    size_t pageCount = entries.size();
+    entries.push_back({SPARSE_SENTINEL_ZIP, size});
+
+    if (skippedTotal > 0) {
+        cerr << " Warning: Skipped " << skippedTotal << " records with an invalid zip code" << endl;
+    }
+    if (!writeBinaryIndex(indexFilename, entries, SPARSE_INDEX_MAGIC)) {
+        return false;
+    }
+    if (verbosity >= 1) {
+        cout << "✅ Indexing complete. Total pages: " << pageCount << " of " << pageSize << " bytes" << endl;
+        cout << "Sparse index successfully saved to " << indexFilename << endl;
+    }
+    return true;
 }
 
 /**
@@ -84,51 +467,248 @@ void ZipIndex::saveIndex(const std::string& indexFilename) {
     }
 
     file.close();
-    cout << "Index successfully saved to " << indexFilename << endl;
+    if (verbosity >= 1) {
+        cout << "Index successfully saved to " << indexFilename << endl;
+    }
+}
+
+/**
+ * @brief Saves the index as a sorted binary file that loadIndex can map and search in place.
+ * @param indexFilename The output index file.
+ * @param withModel Whether to also store a learned model of the entries (see LearnedIndex).
+ * @return true if successful, false otherwise.
+ */
+bool ZipIndex::saveBinaryIndex(const std::string& indexFilename, bool withModel) {
+    vector<Entry> entries;
+    entries.reserve(index.size());
+
+    // std::map keeps the 5-digit keys sorted, which is also their numeric order
+    for (const auto& item : index) {
+        uint32_t key;
+        if (!parseZipKey(item.first, key) || item.second < 0) {
+            cerr << " Warning: Skipping invalid index entry: " << item.first << "," << item.second << endl;
+            continue;
+        }
+        entries.push_back({key, static_cast<uint64_t>(item.second)});
+    }
+
+    if (!writeBinaryIndex(indexFilename, entries, BINARY_INDEX_MAGIC, withModel)) {
+        return false;
+    }
+
+    if (verbosity >= 1) {
+        cout << (withModel ? "Learned" : "Binary") << " index successfully saved to " << indexFilename << endl;
+    }
+    return true;
+}
+
+/**
+ * @brief Saves the index as a direct-address table with one offset slot per 5-digit Zip Code.
+ * @param indexFilename The output index file.
+ * @return true if successful, false otherwise.
+ */
+bool ZipIndex::saveDirectIndex(const std::string& indexFilename) {
+    DirectZipTable table;
+    table.reset();
+    for (const auto& item : index) {
+        uint32_t slot;
+        if (!DirectZipTable::slotFor(item.first, slot) || item.second < 0) {
+            cerr << " Warning: Skipping invalid index entry: " << item.first << "," << item.second << endl;
+            continue;
+        }
+        table.set(slot, item.second);
+    }
+
+    if (!table.save(indexFilename)) {
+        cerr << " Error writing index file: " << indexFilename << endl;
+        return false;
+    }
+
+    if (verbosity >= 1) {
+        cout << "Direct-address index successfully saved to " << indexFilename << endl;
+    }
+    return true;
 }
 
 /**
  * @brief Loads the index from a file.
+ *
+ * Binary and direct-address index files are memory-mapped and searched in
+ * place, so loading only checks the header. Text index files are parsed
+ * into the map.
  * @param indexFilename The index file to load.
  */
 void ZipIndex::loadIndex(const std::string& indexFilename) {
-    ifstream file(indexFilename);
-    if (!file.is_open()) {
+    index.clear();
+    binaryEntries = nullptr;
+    binaryCount = 0;
+    sparse = false;
+    learned = false;
+    directTable.close();
+
+    if (!binaryFile.open(indexFilename)) {
         cerr << " Error opening index file: " << indexFilename << endl;
         return;
     }
 
-    index.clear();
-    string line;
-    string zipCode;
-    long offset;
-    
-    while (getline(file, line)) {
-        stringstream ss(line);
-        getline(ss, zipCode, ',');
-
-        if (ss.good()) {
-            string offsetStr;
-            getline(ss, offsetStr);
-            try {
-                offset = stol(offsetStr);
-                index[zipCode] = offset;
-            } catch (const std::exception& e) {
-                cerr << " Warning: Invalid offset value in line: " << line << endl;
-            }
+    const char* data = binaryFile.data();
+    size_t size = binaryFile.size();
+    if (DirectZipTable::isTableFile(data, size)) {
+        binaryFile.close();
+        if (!directTable.load(indexFilename)) {
+            cerr << " Error: Corrupt direct-address index file: " << indexFilename << endl;
+            return;
         }
+        cout << " Index loaded successfully with " << directTable.size() << " entries." << endl;
+        return;
     }
-    file.close();
-    
+    bool isSparseFile = size >= sizeof(SPARSE_INDEX_MAGIC) && equal(SPARSE_INDEX_MAGIC, SPARSE_INDEX_MAGIC + 8, data);
+    bool isLearnedFile = size >= sizeof(LEARNED_INDEX_MAGIC) && equal(LEARNED_INDEX_MAGIC, LEARNED_INDEX_MAGIC + 8, data);
+    if (isSparseFile || isLearnedFile ||
+        (size >= sizeof(BINARY_INDEX_MAGIC) && equal(BINARY_INDEX_MAGIC, BINARY_INDEX_MAGIC + 8, data))) {
+        uint64_t count = size >= BINARY_INDEX_HEADER_SIZE ? getLE(data + 16, 8) : 0;
+        bool valid = size >= BINARY_INDEX_HEADER_SIZE && getLE(data + 8, 4) == BINARY_INDEX_VERSION &&
+                     getLE(data + 12, 4) == BINARY_INDEX_ENTRY_SIZE &&
+                     count <= (size - BINARY_INDEX_HEADER_SIZE) / BINARY_INDEX_ENTRY_SIZE;
+        size_t entriesEnd = valid ? BINARY_INDEX_HEADER_SIZE + count * BINARY_INDEX_ENTRY_SIZE : 0;
+        if (valid && isLearnedFile) {
+            // The model follows the entries and must have been fitted on them
+            auto keyAt = [&](size_t i) { return getLE(data + BINARY_INDEX_HEADER_SIZE + i * BINARY_INDEX_ENTRY_SIZE, 4); };
+            valid = learnedModel.deserialize(data + entriesEnd, size - entriesEnd) && learnedModel.matches(count, keyAt);
+        } else if (valid) {
+            valid = entriesEnd == size && (!isSparseFile || count > 0);
+        }
+        if (!valid) {
+            cerr << " Error: Corrupt binary index file: " << indexFilename << endl;
+            binaryFile.close();
+            return;
+        }
+
+        binaryEntries = data + BINARY_INDEX_HEADER_SIZE;
+        binaryCount = count;
+        binaryChecksum = getLE(data + 24, 8);
+        sparse = isSparseFile;
+        learned = isLearnedFile;
+        if (sparse) {
+            cout << " Sparse index loaded successfully with " << binaryCount - 1 << " pages." << endl;
+        } else if (learned) {
+            cout << " Learned index loaded successfully with " << binaryCount << " entries and "
+                 << learnedModel.segmentCount() << " segments." << endl;
+        } else {
+            cout << " Index loaded successfully with " << binaryCount << " entries." << endl;
+        }
+        return;
+    }
+
+    // Text index: one "zip,offset" line per entry
+    CSVLineReader reader(data, size);
+    string_view line;
+    while (reader.nextLine(line)) {
+        size_t comma = line.find(',');
+        if (comma == string_view::npos) {
+            continue;
+        }
+
+        long offset;
+        if (CSVTokenizer::parseInt(line.substr(comma + 1), offset)) {
+            index[string(line.substr(0, comma))] = offset;
+        } else {
+            cerr << " Warning: Invalid offset value in line: " << line << endl;
+        }
+    }
+    binaryFile.close();
+
     cout << " Index loaded successfully with " << index.size() << " entries." << endl;
 }
 
+/**
+ * @brief Checks the stored checksum of a binary index (text indexes always pass).
+ * @return true if the entries match the checksum, false otherwise.
+ */
+bool ZipIndex::verifyIndex() const {
+    if (!binaryEntries) {
+        return true;
+    }
+    return checksumEntries(binaryEntries, binaryCount * BINARY_INDEX_ENTRY_SIZE) == binaryChecksum;
+}
+
+/**
+ * @brief Gets the number of entries in the loaded or built index.
+ * @return The entry count.
+ */
+size_t ZipIndex::size() const {
+    if (directTable.isOpen()) {
+        return directTable.size();
+    }
+    if (sparse) {
+        return binaryCount - 1; // Pages, not counting the sentinel
+    }
+    return binaryEntries ? binaryCount : index.size();
+}
+
+/**
+ * @brief Checks if the loaded index is sparse (one entry per page rather than per record).
+ * @return true for a sparse index, false otherwise.
+ */
+bool ZipIndex::isSparse() const {
+    return sparse;
+}
+
 /**
  * @brief Finds the byte offset of a given Zip Code.
+ *
+ * A sparse index does not know record offsets without reading the data
+ * file, so it always returns -1 here; use findRecord instead.
  * @param zipCode The Zip Code to search for.
  * @return The byte offset if found, or -1 if not found.
  */
 long ZipIndex::findZipCode(const std::string& zipCode) const {
+    if (sparse) {
+        return -1;
+    }
+
+    if (directTable.isOpen()) {
+        uint32_t slot;
+        if (!DirectZipTable::slotFor(zipCode, slot)) {
+            return -1;
+        }
+        int64_t offset = directTable.get(slot);
+        return offset == DirectZipTable::NO_ENTRY ? -1 : static_cast<long>(offset);
+    }
+
+    if (binaryEntries) {
+        uint32_t key;
+        if (!parseZipKey(zipCode, key)) {
+            return -1;
+        }
+
+        if (learned) {
+            // The model predicts the entry within a few positions; only that window is searched
+            auto keyAt = [this](size_t i) { return getLE(binaryEntries + i * BINARY_INDEX_ENTRY_SIZE, 4); };
+            size_t position = learnedModel.lowerBound(key, keyAt);
+            if (position < binaryCount && keyAt(position) == key) {
+                return static_cast<long>(getLE(binaryEntries + position * BINARY_INDEX_ENTRY_SIZE + 4, 8));
+            }
+            return -1;
+        }
+
+        // Binary search over the packed entries in the mapping
+        uint64_t low = 0, high = binaryCount;
+        while (low < high) {
+            uint64_t mid = low + (high - low) / 2;
+            const char* entry = binaryEntries + mid * BINARY_INDEX_ENTRY_SIZE;
+            uint32_t midKey = static_cast<uint32_t>(getLE(entry, 4));
+            if (midKey < key) {
+                low = mid + 1;
+            } else if (midKey > key) {
+                high = mid;
+            } else {
+                return static_cast<long>(getLE(entry + 4, 8));
+            }
+        }
+        return -1;
+    }
+
     string formattedZip = zipCode;
     while (formattedZip.length() < 5) {
         formattedZip = "0" + formattedZip;
@@ -140,3 +720,151 @@ long ZipIndex::findZipCode(const std::string& zipCode) const {
     }
     return -1;
 }
+
+/**
+ * @brief Scans a page of length-indicated records for a Zip Code.
+ * @param page The page bytes.
+ * @param key The Zip Code.
+ * @param record Output parameter for the record line of the last match (including its length prefix).
+ * @return The position of the last matching record in the page, or string_view::npos if none.
+ */
+static size_t scanPage(string_view page, uint32_t key, string& record) {
+    size_t found = string_view::npos;
+    size_t pos = 0;
+    while (pos < page.size()) {
+        size_t payload;
+        size_t next = nextRecordOffset(page.data(), page.size(), pos, payload);
+        if (next == 0) {
+            break;
+        }
+        uint32_t zip;
+        if (parseRecordZip(page.data(), payload, next, zip)) {
+            if (zip > key) {
+                break;
+            }
+            if (zip == key) {
+                size_t end = next;
+                while (end > pos && (page[end - 1] == '\n' || page[end - 1] == '\r')) {
+                    end--;
+                }
+                record.assign(page.data() + pos, end - pos);
+                found = pos;
+            }
+        }
+        pos = next;
+    }
+    return found;
+}
+
+/**
+ * @brief Finds the page of a sparse index that could hold a Zip Code.
+ * @param zipCode The Zip Code.
+ * @param key Output parameter for the Zip Code's integer key.
+ * @param pageStart Output parameter for the offset of the page.
+ * @param pageEnd Output parameter for the offset just past the page.
+ * @return true if a page could hold the Zip Code, false otherwise.
+ */
+bool ZipIndex::findSparsePage(const std::string& zipCode, uint32_t& key, uint64_t& pageStart, uint64_t& pageEnd) const {
+    if (!sparse || !parseZipKey(zipCode, key)) {
+        return false;
+    }
+
+    // Last page whose first Zip Code is <= key (the sentinel entry is never chosen)
+    uint64_t low = 0, high = binaryCount - 1;
+    while (low < high) {
+        uint64_t mid = low + (high - low) / 2;
+        if (static_cast<uint32_t>(getLE(binaryEntries + mid * BINARY_INDEX_ENTRY_SIZE, 4)) <= key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == 0) {
+        return false;
+    }
+    const char* entry = binaryEntries + (low - 1) * BINARY_INDEX_ENTRY_SIZE;
+    pageStart = getLE(entry + 4, 8);
+    pageEnd = getLE(entry + BINARY_INDEX_ENTRY_SIZE + 4, 8);
+    return pageEnd > pageStart;
+}
+
+/**
+ * @brief Finds a Zip Code and reads its record from the data file.
+ *
+ * With a sparse index, the page that could hold the Zip Code is found by
+ * binary search, read with a single read call and scanned record by record.
+ * Other indexes give the record offset directly.
+ * @param dataFilename The length-indicated data file the index was built from.
+ * @param zipCode The Zip Code to search for.
+ * @param record Output parameter for the record line (including its length prefix).
+ * @return The byte offset of the record if found, or -1 if not found.
+ */
+long ZipIndex::findRecord(const std::string& dataFilename, const std::string& zipCode, std::string& record) const {
+    record.clear();
+    if (!sparse) {
+        long offset = findZipCode(zipCode);
+        if (offset == -1) {
+            return -1;
+        }
+        ifstream file(dataFilename, ios::binary);
+        file.seekg(offset);
+        if (!file || !getline(file, record)) {
+            return -1;
+        }
+        if (!record.empty() && record.back() == '\r') {
+            record.pop_back();
+        }
+        return offset;
+    }
+
+    uint32_t key;
+    uint64_t pageStart, pageEnd;
+    if (!findSparsePage(zipCode, key, pageStart, pageEnd)) {
+        return -1;
+    }
+    string page(pageEnd - pageStart, '\0');
+    ifstream file(dataFilename, ios::binary);
+    file.seekg(pageStart);
+    if (!file || !file.read(&page[0], page.size())) {
+        cerr << " Error: Unable to read page at offset " << pageStart << " of " << dataFilename << endl;
+        return -1;
+    }
+
+    // The last match wins among duplicate Zip Codes, as in the full index
+    size_t found = scanPage(page, key, record);
+    return found == string_view::npos ? -1 : static_cast<long>(pageStart + found);
+}
+
+/**
+ * @brief Finds a Zip Code and copies its record from data file contents already in memory.
+ *
+ * Used by long-lived processes that keep the data file mapped, so a lookup
+ * makes no system calls.
+ * @param data The contents of the data file the index was built from (e.g. a MappedFile view).
+ * @param zipCode The Zip Code to search for.
+ * @param record Output parameter for the record line (including its length prefix).
+ * @return The byte offset of the record if found, or -1 if not found.
+ */
+long ZipIndex::findRecord(std::string_view data, const std::string& zipCode, std::string& record) const {
+    record.clear();
+    if (!sparse) {
+        long offset = findZipCode(zipCode);
+        if (offset < 0 || static_cast<size_t>(offset) >= data.size()) {
+            return -1;
+        }
+        string_view line = data.substr(offset, data.find('\n', offset) - offset);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        record.assign(line);
+        return offset;
+    }
+
+    uint32_t key;
+    uint64_t pageStart, pageEnd;
+    if (!findSparsePage(zipCode, key, pageStart, pageEnd) || pageEnd > data.size()) {
+        return -1;
+    }
+    size_t found = scanPage(data.substr(pageStart, pageEnd - pageStart), key, record);
+    return found == string_view::npos ? -1 : static_cast<long>(pageStart + found);
+}
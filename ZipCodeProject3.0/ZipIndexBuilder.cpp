@@ -2,28 +2,73 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cstdlib>
+#include <algorithm>
 
 using namespace std;
 
 /**
  * @brief Main function for building and saving the zip code index.
  * @param argc Number of command-line arguments.
- * @param argv Command-line argument list.
+ * @param argv Command-line argument list: datafile, indexfile, an optional index format (text, binary, direct,
+ *             sparse or learned), and optional flags: -v lists every indexed Zip Code, -q prints errors only, -j<N> sets
+ *             the number of threads used to build a binary index.
  * @return 0 on success, 1 on failure.
  */
 int main(int argc, char* argv[]) {
     if (argc < 3) {
-        cerr << " Usage: " << argv[0] << " <datafile> <indexfile>\n";
+        cerr << " Usage: " << argv[0] << " <datafile> <indexfile> [text|binary|direct|sparse|learned] [-v|-q] [-j<threads>]\n";
         return 1;
     }
 
     string dataFilename = argv[1];
     string indexFilename = argv[2];
+    string format = "text";
+    int verbosity = 1;
+    unsigned threads = 0; // 0 uses every hardware thread
+
+    for (int i = 3; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-v") {
+            verbosity = 2;
+        } else if (arg == "-q") {
+            verbosity = 0;
+        } else if (arg.size() > 2 && arg.compare(0, 2, "-j") == 0) {
+            threads = static_cast<unsigned>(max(0, atoi(arg.c_str() + 2)));
+        } else {
+            format = arg;
+        }
+    }
+    if (format != "text" && format != "binary" && format != "direct" && format != "sparse" && format != "learned") {
+        cerr << " Error: Index format must be text, binary, direct, sparse or learned\n";
+        return 1;
+    }
 
     ZipIndex index;
-    index.buildIndex(dataFilename);
-    index.saveIndex(indexFilename);
+    index.setVerbosity(verbosity);
+    if (format == "binary" || format == "learned") {
+        // Built in one pass from the length prefixes, without the in-memory map
+        if (!index.buildBinaryIndex(dataFilename, indexFilename, threads, format == "learned")) {
+            return 1;
+        }
+    } else if (format == "sparse") {
+        // One entry per 4 KB page of a file sorted by Zip Code
+        if (!index.buildSparseIndex(dataFilename, indexFilename)) {
+            return 1;
+        }
+    } else {
+        index.buildIndex(dataFilename);
+        if (format == "direct") {
+            if (!index.saveDirectIndex(indexFilename)) {
+                return 1;
+            }
+        } else {
+            index.saveIndex(indexFilename);
+        }
+    }
 
-    cout << " Index created from " << dataFilename << " and saved as " << indexFilename << endl;
+    if (verbosity >= 1) {
+        cout << " Index created from " << dataFilename << " and saved as " << indexFilename << endl;
+    }
     return 0;
 }
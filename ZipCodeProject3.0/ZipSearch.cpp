@@ -1,27 +1,86 @@
 #include <iostream>
 #include <fstream>
 #include "ZipIndex.h"
+#include "MappedFile.h"
+#include "QueryServer.h"
 
 using namespace std;
 
+/**
+ * @brief Answers Zip Code queries until input ends, keeping the index and data file loaded.
+ * @param index The loaded index.
+ * @param dataFilename The data file the index was built from.
+ * @param socketPath Unix domain socket to listen on, or empty to use stdin/stdout.
+ * @return 0 when input ends, 1 if the data file or socket cannot be opened.
+ */
+static int serve(const ZipIndex& index, const string& dataFilename, const string& socketPath) {
+    MappedFile data(dataFilename);
+    if (!data.isOpen()) {
+        cerr << " Error: Unable to open data file: " << dataFilename << endl;
+        return 1;
+    }
+
+    // One response line per query: "OK <record>" or "NOT_FOUND <zip>"
+    string record;
+    QueryServer server([&](string_view query, string& response) {
+        string zipCode(query);
+        if (index.findRecord(data.view(), zipCode, record) == -1) {
+            response = "NOT_FOUND " + zipCode;
+        } else {
+            response = "OK " + record;
+        }
+    });
+
+    cerr << " Serving queries from " << (socketPath.empty() ? "stdin" : socketPath) << endl;
+    if (!socketPath.empty()) {
+        return server.serveSocket(socketPath) ? 0 : 1;
+    }
+    ios::sync_with_stdio(false);
+    server.serveStream(cin, cout);
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 4) {
-        cout << "Usage: " << argv[0] << " <datafile> <indexfile> -Z<zip>\n";
+        cout << "Usage: " << argv[0] << " <datafile> <indexfile> -Z<zip> [-V]\n";
+        cout << "       " << argv[0] << " <datafile> <indexfile> -S [-U<socket>] [-V]\n";
         return 1;
     }
 
     string dataFilename = argv[1];
     string indexFilename = argv[2];
     string zipCode;
+    bool verify = false; // -V checks a binary index's checksum before searching
+    bool server = false; // -S answers queries until input ends
+    string socketPath;   // -U<path> serves a Unix domain socket instead of stdin/stdout
 
     for (int i = 3; i < argc; ++i) {
         string arg = argv[i];
-        if (arg.size() > 2 && arg[0] == '-' && arg[1] == 'Z') {
+        if (arg.size() > 2 && arg[0] == '-' && arg[1] == 'Z' && zipCode.empty()) {
             zipCode = arg.substr(2);
-            break;
+        } else if (arg == "-V") {
+            verify = true;
+        } else if (arg == "-S") {
+            server = true;
+        } else if (arg.size() > 2 && arg.compare(0, 2, "-U") == 0) {
+            server = true;
+            socketPath = arg.substr(2);
         }
     }
 
+    if (server) {
+        // stdout carries responses, so load messages go to stderr
+        ZipIndex index;
+        streambuf* saved = cout.rdbuf(cerr.rdbuf());
+        index.loadIndex(indexFilename);
+        cout.rdbuf(saved);
+        if (verify && !index.verifyIndex()) {
+            cerr << " Error: Index checksum does not match: " << indexFilename << endl;
+            return 1;
+        }
+        return serve(index, dataFilename, socketPath);
+    }
+
     if (zipCode.empty()) {
         cerr << " Error: No valid ZIP code provided for search.\n";
         return 1;
@@ -32,6 +91,23 @@ int main(int argc, char* argv[]) {
     ZipIndex index;
     cout << "📥 Loading index from " << indexFilename << endl;
     index.loadIndex(indexFilename);
+    if (verify && !index.verifyIndex()) {
+        cerr << " Error: Index checksum does not match: " << indexFilename << endl;
+        return 1;
+    }
+
+    if (index.isSparse()) {
+        // The sparse index only locates the page; reading and scanning it finds the record
+        string record;
+        long offset = index.findRecord(dataFilename, zipCode, record);
+        if (offset == -1) {
+            cout << " ZIP Code " << zipCode << " not found in data file.\n";
+            return 0;
+        }
+        cout << "Found at file position: " << offset << endl;
+        cout << "ZIP Code Record: " << record << endl;
+        return 0;
+    }
 
     long offset = index.findZipCode(zipCode);
     if (offset == -1) {
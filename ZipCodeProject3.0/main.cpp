@@ -16,6 +16,7 @@
 #include <algorithm>
 #include "Buffer.h"
 #include "HeaderBuffer.h"
+#include "RecordSort.h"
 
 using namespace std;
 
@@ -69,15 +70,22 @@ int main() {
         cout << "Invalid choice! Please enter 'Z' for Zip Code or 'P' for Place Name.\n";
     }
 
-    if (sortChoice == 'Z') { // Sort data based on user choice
-        sort(records.begin(), records.end(), [](const ZipCodeRecord& a, const ZipCodeRecord& b) {
-            return a.zip_code < b.zip_code;
-        });
+    // Sort data based on user choice: the keys are sorted into an order, then each record is moved once
+    vector<uint32_t> order;
+    if (sortChoice == 'Z') {
+        vector<uint32_t> keys(records.size());
+        for (size_t i = 0; i < records.size(); i++) {
+            keys[i] = static_cast<uint32_t>(records[i].zip_code);
+        }
+        order = RecordSort::radixOrder(keys);
     } else {
-        sort(records.begin(), records.end(), [](const ZipCodeRecord& a, const ZipCodeRecord& b) {
-            return a.place_name < b.place_name;
-        });
+        vector<string_view> keys(records.size());
+        for (size_t i = 0; i < records.size(); i++) {
+            keys[i] = records[i].place_name;
+        }
+        order = RecordSort::stringOrder(keys);
     }
+    RecordSort::applyOrder(records, order);
 
     buffer.processRecords(records, state_map);
 
@@ -104,7 +112,7 @@ int main() {
         const string& state = entry.first;
         const vector<ZipCodeRecord>& zipRecords = entry.second;
 
-        string eastPlace, westPlace, northPlace, southPlace;
+        string_view eastPlace, westPlace, northPlace, southPlace;
         int eastZip, westZip, northZip, southZip;
         double minLon = numeric_limits<double>::max();
         double maxLon = numeric_limits<double>::lowest();
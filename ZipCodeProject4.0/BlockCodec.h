@@ -0,0 +1,294 @@
+/**
+ * @file BlockCodec.h
+ * @brief Definition of the BlockCodec class for compressing sequence set blocks
+ *
+ * The built-in codec is a small LZ77 variant (LZ4-style token stream).
+ * Building with -DBSS_USE_ZSTD and linking -lzstd enables the zstd codec.
+ */
+
+#ifndef BLOCK_CODEC_H
+#define BLOCK_CODEC_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#ifdef BSS_USE_ZSTD
+#include <zstd.h>
+#endif
+
+/**
+ * @brief Compression codecs for block extents
+ */
+enum BlockCodecType : uint8_t {
+    CODEC_NONE = 0,     ///< Stored uncompressed
+    CODEC_LZ = 1,       ///< Built-in LZ77 codec
+    CODEC_ZSTD = 2      ///< zstd (requires BSS_USE_ZSTD)
+};
+
+/**
+ * @class BlockCodec
+ * @brief Stateless block compressor and decompressor
+ */
+class BlockCodec {
+private:
+    static const int MIN_MATCH = 4;         ///< Shortest match worth encoding
+    static const int HASH_BITS = 12;        ///< log2 of the match finder table size
+    static const int MAX_OFFSET = 65535;    ///< Largest back-reference distance
+
+    /**
+     * @brief Hash the 4 bytes at a position
+     * @param p Pointer to at least 4 bytes
+     * @return The hash table slot
+     */
+    static uint32_t hash4(const char* p) {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return (v * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    /**
+     * @brief Append an LZ length extension (runs of 255 plus remainder)
+     * @param out The output string
+     * @param len The length beyond the token nibble
+     */
+    static void appendLength(std::string& out, int len) {
+        while (len >= 255) {
+            out.push_back(static_cast<char>(255));
+            len -= 255;
+        }
+        out.push_back(static_cast<char>(len));
+    }
+
+    /**
+     * @brief Append one LZ sequence (literals, then an optional match)
+     * @param out The output string
+     * @param literals Start of the literal bytes
+     * @param literalLen Number of literal bytes
+     * @param offset Match distance (ignored if matchLen is 0)
+     * @param matchLen Match length (0 for the final literal-only sequence)
+     */
+    static void appendSequence(std::string& out, const char* literals, int literalLen,
+                               int offset, int matchLen) {
+        int litNibble = literalLen < 15 ? literalLen : 15;
+        int matchCode = matchLen > 0 ? matchLen - MIN_MATCH : 0;
+        int matchNibble = matchCode < 15 ? matchCode : 15;
+        out.push_back(static_cast<char>((litNibble << 4) | matchNibble));
+        if (litNibble == 15) {
+            appendLength(out, literalLen - 15);
+        }
+        out.append(literals, literalLen);
+        if (matchLen > 0) {
+            out.push_back(static_cast<char>(offset & 0xFF));
+            out.push_back(static_cast<char>((offset >> 8) & 0xFF));
+            if (matchNibble == 15) {
+                appendLength(out, matchCode - 15);
+            }
+        }
+    }
+
+    /**
+     * @brief Read an LZ length extension
+     * @param src Compressed bytes
+     * @param pos Current position; advanced past the extension
+     * @param srcLen Number of compressed bytes
+     * @param len Length to add the extension to
+     * @return true if successful, false if the input is truncated
+     */
+    static bool readLength(const unsigned char* src, int& pos, int srcLen, int& len) {
+        unsigned char byte;
+        do {
+            if (pos >= srcLen) {
+                return false;
+            }
+            byte = src[pos++];
+            len += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+public:
+    /**
+     * @brief Compress a block with the built-in LZ codec
+     * @param src Uncompressed bytes
+     * @param srcLen Number of uncompressed bytes
+     * @param out Output parameter for the compressed bytes
+     */
+    static void compressLZ(const char* src, int srcLen, std::string& out) {
+        out.clear();
+        out.reserve(srcLen + srcLen / 255 + 16);
+
+        std::vector<int> table(1 << HASH_BITS, -1);
+        int anchor = 0;
+        int pos = 0;
+        int limit = srcLen - MIN_MATCH;
+
+        while (pos <= limit) {
+            uint32_t h = hash4(src + pos);
+            int candidate = table[h];
+            table[h] = pos;
+
+            if (candidate >= 0 && pos - candidate <= MAX_OFFSET &&
+                std::memcmp(src + candidate, src + pos, MIN_MATCH) == 0) {
+                int matchLen = MIN_MATCH;
+                while (pos + matchLen < srcLen && src[candidate + matchLen] == src[pos + matchLen]) {
+                    matchLen++;
+                }
+                appendSequence(out, src + anchor, pos - anchor, pos - candidate, matchLen);
+                pos += matchLen;
+                anchor = pos;
+            } else {
+                pos++;
+            }
+        }
+
+        // Final literals
+        appendSequence(out, src + anchor, srcLen - anchor, 0, 0);
+    }
+
+    /**
+     * @brief Decompress a block produced by compressLZ
+     * @param src Compressed bytes
+     * @param srcLen Number of compressed bytes
+     * @param dst Destination for the uncompressed bytes
+     * @param dstLen Expected number of uncompressed bytes
+     * @return true if exactly dstLen bytes were produced, false on corrupt input
+     */
+    static bool decompressLZ(const char* src, int srcLen, char* dst, int dstLen) {
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(src);
+        int ip = 0;
+        int op = 0;
+
+        while (ip < srcLen) {
+            int token = in[ip++];
+
+            int literalLen = token >> 4;
+            if (literalLen == 15 && !readLength(in, ip, srcLen, literalLen)) {
+                return false;
+            }
+            if (ip + literalLen > srcLen || op + literalLen > dstLen) {
+                return false;
+            }
+            std::memcpy(dst + op, src + ip, literalLen);
+            ip += literalLen;
+            op += literalLen;
+
+            // The last sequence carries literals only
+            if (ip >= srcLen) {
+                break;
+            }
+
+            if (ip + 2 > srcLen) {
+                return false;
+            }
+            int offset = in[ip] | (in[ip + 1] << 8);
+            ip += 2;
+
+            int matchLen = token & 0x0F;
+            if (matchLen == 15 && !readLength(in, ip, srcLen, matchLen)) {
+                return false;
+            }
+            matchLen += MIN_MATCH;
+
+            if (offset == 0 || offset > op || op + matchLen > dstLen) {
+                return false;
+            }
+            // Byte-wise copy: matches may overlap their own output
+            for (int i = 0; i < matchLen; i++) {
+                dst[op + i] = dst[op - offset + i];
+            }
+            op += matchLen;
+        }
+
+        return op == dstLen;
+    }
+
+    /**
+     * @brief Compress a block
+     * @param codec The codec to use
+     * @param src Uncompressed bytes
+     * @param srcLen Number of uncompressed bytes
+     * @param out Output parameter for the compressed bytes
+     * @return true if successful, false if the codec is unavailable
+     */
+    static bool compress(BlockCodecType codec, const char* src, int srcLen, std::string& out) {
+        switch (codec) {
+            case CODEC_NONE:
+                out.assign(src, srcLen);
+                return true;
+            case CODEC_LZ:
+                compressLZ(src, srcLen, out);
+                return true;
+            case CODEC_ZSTD:
+#ifdef BSS_USE_ZSTD
+            {
+                out.resize(ZSTD_compressBound(srcLen));
+                size_t n = ZSTD_compress(&out[0], out.size(), src, srcLen, 3);
+                if (ZSTD_isError(n)) {
+                    return false;
+                }
+                out.resize(n);
+                return true;
+            }
+#else
+                return false;
+#endif
+        }
+        return false;
+    }
+
+    /**
+     * @brief Decompress a block
+     * @param codec The codec the block was compressed with
+     * @param src Compressed bytes
+     * @param srcLen Number of compressed bytes
+     * @param dst Destination for the uncompressed bytes
+     * @param dstLen Expected number of uncompressed bytes
+     * @return true if successful, false on corrupt input or unavailable codec
+     */
+    static bool decompress(BlockCodecType codec, const char* src, int srcLen, char* dst, int dstLen) {
+        switch (codec) {
+            case CODEC_NONE:
+                if (srcLen != dstLen) {
+                    return false;
+                }
+                std::memcpy(dst, src, srcLen);
+                return true;
+            case CODEC_LZ:
+                return decompressLZ(src, srcLen, dst, dstLen);
+            case CODEC_ZSTD:
+#ifdef BSS_USE_ZSTD
+                return ZSTD_decompress(dst, dstLen, src, srcLen) == static_cast<size_t>(dstLen);
+#else
+                return false;
+#endif
+        }
+        return false;
+    }
+
+    /**
+     * @brief Parse a codec name from the file header
+     * @param name "none", "lz" or "zstd"
+     * @return The codec (CODEC_NONE for unknown names)
+     */
+    static BlockCodecType fromName(const std::string& name) {
+        if (name == "lz") return CODEC_LZ;
+        if (name == "zstd") return CODEC_ZSTD;
+        return CODEC_NONE;
+    }
+
+    /**
+     * @brief Check whether a codec was compiled in
+     * @param codec The codec
+     * @return true if the codec can be used
+     */
+    static bool isAvailable(BlockCodecType codec) {
+#ifdef BSS_USE_ZSTD
+        return true;
+#else
+        return codec != CODEC_ZSTD;
+#endif
+    }
+};
+
+#endif // BLOCK_CODEC_H
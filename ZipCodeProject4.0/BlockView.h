@@ -0,0 +1,454 @@
+/**
+ * @file BlockView.h
+ * @brief Definition of the BlockView and RecordView classes for reading records in place
+ */
+
+#ifndef BLOCK_VIEW_H
+#define BLOCK_VIEW_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include "BlockBuffer.h"
+#include "ZipCodeRecord.h"
+
+/**
+ * @class RecordView
+ * @brief Lightweight view of one packed record inside a block
+ *
+ * Fields are located and decoded on demand; nothing is copied until
+ * toRecord() is called. The view is only valid while the block bytes live.
+ */
+class RecordView {
+private:
+    std::string_view data;    ///< Record payload without the length prefix
+    RecordFormat format;      ///< Encoding of the payload
+    const RecordDictionary* dictionary; ///< String dictionary for dictionary-encoded records
+    char zipText[MAX_BINARY_ZIP_DIGITS]; ///< Zip Code text for binary records, leading zeros included
+    int zipLength;            ///< Length of zipText
+
+    /**
+     * @brief Get a string field of a binary record
+     * @param index Zero-based index among the varint-prefixed strings
+     * @return The field bytes, or an empty view if the data is truncated
+     */
+    std::string_view getBinaryString(int index) const {
+        size_t pos = BINARY_RECORD_FIXED_BYTES;
+        std::string_view field;
+        for (int i = 0; i <= index; i++) {
+            if (!readVarString(data, pos, field)) {
+                return std::string_view();
+            }
+        }
+        return field;
+    }
+
+    /**
+     * @brief Get a fixed-point coordinate of a binary record
+     * @param offset Byte offset of the coordinate within the payload
+     * @return The coordinate in degrees
+     */
+    double getBinaryCoordinate(int offset) const {
+        if (data.size() < static_cast<size_t>(BINARY_RECORD_FIXED_BYTES)) {
+            return 0.0;
+        }
+        return decodeBinaryCoordinate(data.data() + offset);
+    }
+
+public:
+    /**
+     * @brief Default constructor (empty view)
+     */
+    RecordView() : format(RECORD_FORMAT_CSV), dictionary(nullptr), zipText(), zipLength(0) {}
+
+    /**
+     * @brief Constructor
+     * @param payload The encoded record payload
+     * @param record_format Encoding of the payload
+     * @param dict String dictionary (required for RECORD_FORMAT_DICTIONARY)
+     */
+    explicit RecordView(std::string_view payload, RecordFormat record_format = RECORD_FORMAT_CSV,
+                        const RecordDictionary* dict = nullptr)
+        : data(payload), format(record_format), dictionary(dict), zipText(), zipLength(0) {
+        if (format != RECORD_FORMAT_CSV && data.size() >= static_cast<size_t>(BINARY_RECORD_FIXED_BYTES)) {
+            zipLength = formatBinaryZip(data.data(), zipText);
+        }
+    }
+
+    /**
+     * @brief Get a field by position
+     *
+     * For binary records the coordinates have no text form, so fields 4 and 5
+     * are empty; use getLatitude()/getLongitude() instead.
+     * @param index Zero-based field index
+     * @return The field bytes, or an empty view if the field does not exist
+     */
+    std::string_view getField(int index) const {
+        if (format != RECORD_FORMAT_CSV) {
+            if (index == 0) {
+                return std::string_view(zipText, zipLength);
+            }
+            if (index >= 1 && index <= 3) {
+                if (format == RECORD_FORMAT_BINARY) {
+                    return getBinaryString(index - 1);
+                }
+                uint32_t code = 0;
+                if (!dictionary || !getDictionaryCode(static_cast<DictionaryColumn>(index - 1), code)) {
+                    return std::string_view();
+                }
+                return dictionary->decode(static_cast<DictionaryColumn>(index - 1), code);
+            }
+            return std::string_view();
+        }
+
+        size_t start = 0;
+        for (int i = 0; i < index; i++) {
+            size_t comma = data.find(',', start);
+            if (comma == std::string_view::npos) {
+                return std::string_view();
+            }
+            start = comma + 1;
+        }
+        size_t end = data.find(',', start);
+        if (end == std::string_view::npos) {
+            end = data.size();
+        }
+        return data.substr(start, end - start);
+    }
+
+    /**
+     * @brief Get the dictionary code of a string field
+     *
+     * Lets equality filters compare integers instead of strings.
+     * @param column The dictionary column
+     * @param code Output parameter for the code
+     * @return true if the record is dictionary encoded and the code was read
+     */
+    bool getDictionaryCode(DictionaryColumn column, uint32_t& code) const {
+        if (format != RECORD_FORMAT_DICTIONARY) {
+            return false;
+        }
+        size_t pos = BINARY_RECORD_FIXED_BYTES;
+        for (int i = 0; i <= column; i++) {
+            if (!readVarint(data, pos, code)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Get the Zip Code (primary key)
+     *
+     * For binary records the returned view points into this RecordView.
+     * @return The Zip Code
+     */
+    std::string_view getZipCode() const { return getField(0); }
+
+    /**
+     * @brief Get the city name
+     * @return The city name
+     */
+    std::string_view getCityName() const { return getField(1); }
+
+    /**
+     * @brief Get the state name
+     * @return The state name
+     */
+    std::string_view getStateName() const { return getField(2); }
+
+    /**
+     * @brief Get the county name
+     * @return The county name
+     */
+    std::string_view getCountyName() const { return getField(3); }
+
+    /**
+     * @brief Get the latitude
+     * @return The latitude, or 0.0 if the field cannot be parsed
+     */
+    double getLatitude() const {
+        return format != RECORD_FORMAT_CSV ? getBinaryCoordinate(4) : parseDouble(getField(4));
+    }
+
+    /**
+     * @brief Get the longitude
+     * @return The longitude, or 0.0 if the field cannot be parsed
+     */
+    double getLongitude() const {
+        return format != RECORD_FORMAT_CSV ? getBinaryCoordinate(8) : parseDouble(getField(5));
+    }
+
+    /**
+     * @brief Get the raw record payload
+     * @return The payload bytes
+     */
+    std::string_view getPayload() const { return data; }
+
+    /**
+     * @brief Materialize the view into a full record
+     * @return A ZipCodeRecord owning copies of the fields
+     */
+    ZipCodeRecord toRecord() const {
+        return ZipCodeRecord(std::string(getZipCode()), std::string(getCityName()),
+                             std::string(getStateName()), std::string(getCountyName()),
+                             getLatitude(), getLongitude());
+    }
+
+    /**
+     * @brief Parse a double without allocating
+     * @param text The text to parse
+     * @return The parsed value, or 0.0 on error
+     */
+    static double parseDouble(std::string_view text) {
+        double value = 0.0;
+        if (!text.empty() && text.front() == '+') {
+            text.remove_prefix(1);
+        }
+        std::from_chars(text.data(), text.data() + text.size(), value);
+        return value;
+    }
+};
+
+/**
+ * @class BlockView
+ * @brief Read-only view that parses a packed block in place
+ *
+ * Scans walk the length prefixes without any heap allocation. Point lookups
+ * build a record offset table once and binary-search the sorted keys, so
+ * only the matching record is ever decoded. RBN links are returned as
+ * int, like BlockBuffer's (see BlockHeader).
+ */
+class BlockView {
+private:
+    const char* data;                    ///< Start of the block bytes
+    int blockSize;                       ///< Size of the block in bytes
+    int recordSizeBytes;                 ///< Number of bytes for record size
+    bool isBinary;                       ///< Flag for binary or ASCII size format
+    RecordFormat recordFormat;           ///< Encoding of record payloads
+    const RecordDictionary* dictionary;  ///< String dictionary for dictionary-encoded records
+    BlockHeader header;                  ///< Decoded block header
+    mutable std::vector<uint32_t> offsets; ///< Record offsets, built on first lookup
+    mutable bool offsetsBuilt;           ///< Whether offsets is current
+
+    /**
+     * @brief Decode the length prefix at a position
+     * @param pos Offset of the prefix within the block
+     * @return The payload length, or -1 if the prefix is invalid
+     */
+    int readLength(int pos) const {
+        if (pos + recordSizeBytes > blockSize) {
+            return -1;
+        }
+        int len = 0;
+        for (int j = 0; j < recordSizeBytes; j++) {
+            unsigned char c = static_cast<unsigned char>(data[pos + j]);
+            if (isBinary) {
+                len = (len << 8) | c;
+            } else {
+                if (c < '0' || c > '9') {
+                    return -1;
+                }
+                len = len * 10 + (c - '0');
+            }
+        }
+        return len;
+    }
+
+    /**
+     * @brief Build the record offset table used by binary search
+     */
+    void buildOffsets() const {
+        offsets.clear();
+        for (const_iterator it = begin(); it != end(); ++it) {
+            offsets.push_back(static_cast<uint32_t>(it.position()));
+        }
+        offsetsBuilt = true;
+    }
+
+    /**
+     * @brief Get the record view at an offset
+     * @param pos Offset of the record's length prefix
+     * @return The record view
+     */
+    RecordView recordAt(int pos) const {
+        int len = readLength(pos);
+        return RecordView(std::string_view(data + pos + recordSizeBytes, len), recordFormat, dictionary);
+    }
+
+public:
+    /**
+     * @class const_iterator
+     * @brief Forward iterator over the records of a block
+     */
+    class const_iterator {
+    private:
+        const BlockView* view;  ///< The view being iterated
+        int pos;                ///< Offset of the current record's length prefix
+        int index;              ///< Index of the current record
+        int length;             ///< Payload length of the current record
+
+        /**
+         * @brief Load the record at the current position, or move to end
+         */
+        void load() {
+            if (index >= view->getRecordCount()) {
+                index = view->getRecordCount();
+                pos = -1;
+                return;
+            }
+            length = view->readLength(pos);
+            if (length < 0 || pos + view->recordSizeBytes + length > view->blockSize) {
+                index = view->getRecordCount();
+                pos = -1;
+            }
+        }
+
+    public:
+        /**
+         * @brief Constructor
+         * @param v The view to iterate
+         * @param startPos Offset of the first record, or -1 for end
+         * @param startIndex Index of the first record
+         */
+        const_iterator(const BlockView* v, int startPos, int startIndex)
+            : view(v), pos(startPos), index(startIndex), length(0) {
+            if (pos >= 0) {
+                load();
+            }
+        }
+
+        /**
+         * @brief Get the current record
+         * @return A view of the current record
+         */
+        RecordView operator*() const {
+            return RecordView(std::string_view(view->data + pos + view->recordSizeBytes, length),
+                              view->recordFormat, view->dictionary);
+        }
+
+        /**
+         * @brief Advance to the next record
+         * @return This iterator
+         */
+        const_iterator& operator++() {
+            pos += view->recordSizeBytes + length;
+            index++;
+            load();
+            return *this;
+        }
+
+        /**
+         * @brief Get the offset of the current record within the block
+         * @return The offset of the length prefix
+         */
+        int position() const { return pos; }
+
+        bool operator==(const const_iterator& other) const { return pos == other.pos; }
+        bool operator!=(const const_iterator& other) const { return pos != other.pos; }
+    };
+
+    /**
+     * @brief Constructor over raw block bytes
+     * @param bytes Start of the block (must stay alive while the view is used)
+     * @param block_size Size of the block in bytes
+     * @param rec_size_bytes Number of bytes for record size
+     * @param is_binary Flag for binary or ASCII size format
+     * @param record_format Encoding of record payloads
+     * @param dict String dictionary (required for RECORD_FORMAT_DICTIONARY)
+     */
+    BlockView(const char* bytes, int block_size, int rec_size_bytes = 4, bool is_binary = false,
+              RecordFormat record_format = RECORD_FORMAT_CSV, const RecordDictionary* dict = nullptr)
+        : data(bytes), blockSize(block_size), recordSizeBytes(rec_size_bytes),
+          isBinary(is_binary), recordFormat(record_format), dictionary(dict), header(),
+          offsetsBuilt(false) {
+        if (blockSize >= static_cast<int>(sizeof(BlockHeader))) {
+            std::memcpy(&header, data, sizeof(BlockHeader));
+            blockHeaderToLittleEndian(header);
+        }
+    }
+
+    /**
+     * @brief Constructor over the bytes held by a BlockBuffer
+     * @param block The block (must outlive the view)
+     */
+    explicit BlockView(const BlockBuffer& block)
+        : BlockView(block.getBuffer().data(), static_cast<int>(block.getBuffer().size()),
+                    block.getRecordSizeBytes(), block.isBinaryFormat(), block.getRecordFormat(),
+                    block.getDictionary()) {}
+
+    /**
+     * @brief Get an iterator to the first record
+     * @return The iterator
+     */
+    const_iterator begin() const {
+        return const_iterator(this, static_cast<int>(sizeof(BlockHeader)), 0);
+    }
+
+    /**
+     * @brief Get the end iterator
+     * @return The iterator
+     */
+    const_iterator end() const {
+        return const_iterator(this, -1, getRecordCount());
+    }
+
+    /**
+     * @brief Search for a record by Zip Code using binary search
+     * @param zipCode The Zip Code to search for
+     * @param record Output parameter for the found record view
+     * @return true if record was found, false otherwise
+     */
+    bool findRecord(std::string_view zipCode, RecordView& record) const {
+        if (!offsetsBuilt) {
+            buildOffsets();
+        }
+
+        int lo = 0;
+        int hi = static_cast<int>(offsets.size()) - 1;
+        while (lo <= hi) {
+            int mid = lo + (hi - lo) / 2;
+            RecordView candidate = recordAt(offsets[mid]);
+            int cmp = candidate.getZipCode().compare(zipCode);
+            if (cmp == 0) {
+                record = candidate;
+                return true;
+            }
+            if (cmp < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid - 1;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Get the number of records in the block
+     * @return The record count from the block header
+     */
+    int getRecordCount() const { return static_cast<int>(header.recordCount); }
+
+    /**
+     * @brief Get the RBN of the previous block
+     * @return The RBN of the previous block
+     */
+    int getPrevBlockRBN() const { return static_cast<int>(header.prevRBN); }
+
+    /**
+     * @brief Get the RBN of the next block
+     * @return The RBN of the next block
+     */
+    int getNextBlockRBN() const { return static_cast<int>(header.nextRBN); }
+
+    /**
+     * @brief Check if this is an availability list block
+     * @return true if this is an availability list block, false otherwise
+     */
+    bool isAvailBlock() const { return header.blockType == BLOCK_TYPE_AVAIL; }
+};
+
+#endif // BLOCK_VIEW_H
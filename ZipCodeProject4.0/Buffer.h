@@ -13,22 +13,27 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <limits>
 #include <map>
+#include "Arena.h"
 
 using namespace std;
 
 /**
  * @struct ZipCodeRecord
  * @brief Structure to hold zip code data for a given location.
+ *
+ * The text fields are views of strings interned by the Buffer that read the
+ * record, and stay valid until that Buffer is destroyed or released.
  */
 struct ZipCodeRecord {
     int zip_code;         ///< Zip code of the location.
-    string place_name;    ///< City/location name.
-    string state;         ///< Two-letter state abbreviation.
-    string county;        ///< County name (can be empty).
+    string_view place_name; ///< City/location name.
+    string_view state;    ///< Two-letter state abbreviation.
+    string_view county;   ///< County name (can be empty).
     double lat;           ///< Latitude coordinate of the location.
     double lon;           ///< Longitude coordinate of the location.
 };
@@ -38,6 +43,9 @@ struct ZipCodeRecord {
  * @brief A class to handle reading, processing, and validating zip code data.
  */
 class Buffer {
+private:
+    StringInterner strings; ///< One copy of every place, state and county name read
+
 public:
     /**
      * @brief Reads a length-indicated file and stores zip code records.
@@ -46,7 +54,7 @@ public:
      * @return True if the file is read successfully, false otherwise.
      *
      * This function reads a length-indicated file containing zip code data, extracts fields, checks for missing values,
-     * and stores valid records into a vector.
+     * and stores valid records into a vector. Names are interned, so only distinct strings are allocated.
      */
     bool readLengthIndicatedFile(const string& filename, vector<ZipCodeRecord>& records);
 
@@ -55,9 +63,17 @@ public:
      * @param records The vector of zip code records.
      * @param state_map A map to store zip codes categorized by state.
      *
-     * This function groups zip code records by state into a map for easy retrieval.
+     * This function groups zip code records by state into a map for easy retrieval. Each state's vector is
+     * sized once, so grouping allocates per state rather than per record.
      */
     void processRecords(const vector<ZipCodeRecord>& records, map<string, vector<ZipCodeRecord>>& state_map);
+
+    /**
+     * @brief Frees every interned name at once.
+     *
+     * Records read by this Buffer must not be used afterwards.
+     */
+    void release() { strings.release(); }
 };
 
 #endif // BUFFER_H
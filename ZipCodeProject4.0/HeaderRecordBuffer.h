@@ -21,6 +21,10 @@ private:
     int headerRecordSize;           ///< Size of the header record in bytes
     int recordSizeBytes;            ///< Number of bytes for record size
     std::string sizeFormatType;     ///< Format of size (ASCII or binary)
+    std::string recordFormatType;   ///< Encoding of record payloads (CSV or binary)
+    std::string compressionType;    ///< Block compression codec (none, lz or zstd)
+    std::string indexMode;          ///< Primary index mode (blocks, direct or learned)
+    std::string layout;             ///< Physical record order (zip or hilbert)
     int blockSize;                  ///< Size of blocks in bytes
     double minBlockCapacity;        ///< Minimum block capacity (default 50%)
     std::string indexFileName;      ///< Name of the index file
@@ -36,15 +40,21 @@ private:
     bool staleFlag;                 ///< Flag indicating if header is stale
 
 public:
+    static constexpr int CURRENT_VERSION = 2;  ///< Version 2: binary block headers with 64-bit RBN links
+
     /**
      * @brief Default constructor with default values
      */
     HeaderRecordBuffer()
         : fileStructureType("blocked_sequence_set_comma_separated_length_indicated"),
-          version(1),
+          version(CURRENT_VERSION),
           headerRecordSize(0),  // Will be calculated
           recordSizeBytes(4),   // Default: 4 bytes for record size
           sizeFormatType("ASCII"),
+          recordFormatType("CSV"),
+          compressionType("none"),
+          indexMode("blocks"),
+          layout("zip"),
           blockSize(512),       // Default: 512 bytes per block
           minBlockCapacity(0.5), // Default: 50% minimum block capacity
           indexFileName(""),
@@ -79,6 +89,10 @@ public:
                             "HEADER_SIZE=" + std::to_string(calculateHeaderSize()) + "\n" +
                             "RECORD_SIZE_BYTES=" + std::to_string(recordSizeBytes) + "\n" +
                             "SIZE_FORMAT=" + sizeFormatType + "\n" +
+                            "RECORD_FORMAT=" + recordFormatType + "\n" +
+                            "COMPRESSION=" + compressionType + "\n" +
+                            "INDEX_MODE=" + indexMode + "\n" +
+                            "LAYOUT=" + layout + "\n" +
                             "BLOCK_SIZE=" + std::to_string(blockSize) + "\n" +
                             "MIN_BLOCK_CAPACITY=" + std::to_string(minBlockCapacity) + "\n" +
                             "INDEX_FILE=" + indexFileName + "\n" +
@@ -155,6 +169,10 @@ public:
                 else if (key == "HEADER_SIZE") headerRecordSize = std::stoi(value);
                 else if (key == "RECORD_SIZE_BYTES") recordSizeBytes = std::stoi(value);
                 else if (key == "SIZE_FORMAT") sizeFormatType = value;
+                else if (key == "RECORD_FORMAT") recordFormatType = value;
+                else if (key == "COMPRESSION") compressionType = value;
+                else if (key == "INDEX_MODE") indexMode = value;
+                else if (key == "LAYOUT") layout = value;
                 else if (key == "BLOCK_SIZE") blockSize = std::stoi(value);
                 else if (key == "MIN_BLOCK_CAPACITY") minBlockCapacity = std::stod(value);
                 else if (key == "INDEX_FILE") indexFileName = value;
@@ -201,6 +219,10 @@ public:
         size += std::string("HEADER_SIZE=0000").size();
         size += ("RECORD_SIZE_BYTES=" + std::to_string(recordSizeBytes) + "\n").size();
         size += ("SIZE_FORMAT=" + sizeFormatType + "\n").size();
+        size += ("RECORD_FORMAT=" + recordFormatType + "\n").size();
+        size += ("COMPRESSION=" + compressionType + "\n").size();
+        size += ("INDEX_MODE=" + indexMode + "\n").size();
+        size += ("LAYOUT=" + layout + "\n").size();
         size += ("BLOCK_SIZE=" + std::to_string(blockSize) + "\n").size();
         size += ("MIN_BLOCK_CAPACITY=" + std::to_string(minBlockCapacity) + "\n").size();
         size += ("INDEX_FILE=" + indexFileName + "\n").size();
@@ -262,6 +284,30 @@ public:
      */
     std::string getSizeFormatType() const { return sizeFormatType; }
     
+    /**
+     * @brief Get the record format type
+     * @return The record format type ("CSV" or "binary")
+     */
+    std::string getRecordFormatType() const { return recordFormatType; }
+    
+    /**
+     * @brief Get the block compression type
+     * @return The compression type ("none", "lz" or "zstd")
+     */
+    std::string getCompressionType() const { return compressionType; }
+
+    /**
+     * @brief Get the primary index mode
+     * @return The index mode ("blocks", "direct" or "learned")
+     */
+    std::string getIndexMode() const { return indexMode; }
+
+    /**
+     * @brief Get the physical record order
+     * @return The layout ("zip" or "hilbert")
+     */
+    std::string getLayout() const { return layout; }
+    
     /**
      * @brief Get the block size
      * @return The block size
@@ -370,6 +416,30 @@ public:
      */
     void setSizeFormatType(const std::string& format) { sizeFormatType = format; }
     
+    /**
+     * @brief Set the record format type
+     * @param format The record format type ("CSV" or "binary")
+     */
+    void setRecordFormatType(const std::string& format) { recordFormatType = format; }
+    
+    /**
+     * @brief Set the block compression type
+     * @param type The compression type ("none", "lz" or "zstd")
+     */
+    void setCompressionType(const std::string& type) { compressionType = type; }
+
+    /**
+     * @brief Set the primary index mode
+     * @param mode The index mode ("blocks", "direct" or "learned")
+     */
+    void setIndexMode(const std::string& mode) { indexMode = mode; }
+
+    /**
+     * @brief Set the physical record order
+     * @param order The layout ("zip" or "hilbert")
+     */
+    void setLayout(const std::string& order) { layout = order; }
+    
     /**
      * @brief Set the block size
      * @param size The block size
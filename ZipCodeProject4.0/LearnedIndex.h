@@ -0,0 +1,265 @@
+/**
+ * @file LearnedIndex.h
+ * @brief Definition of the LearnedIndex class, an error-bounded piecewise-linear model of sorted keys
+ *
+ * Zip Codes are close to evenly spread integers, so the position of a key
+ * in a sorted array is well predicted by a few straight lines. The model is
+ * fitted so every key it was built from is predicted within maxError
+ * positions; a lookup evaluates one segment and then searches only that
+ * window. A few hundred segments replace one tree node per key.
+ */
+
+#ifndef LEARNED_INDEX_H
+#define LEARNED_INDEX_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "LittleEndian.h"
+
+/**
+ * @class LearnedIndex
+ * @brief Piecewise-linear key → position model with a bounded local search
+ */
+class LearnedIndex {
+public:
+    static constexpr uint32_t DEFAULT_MAX_ERROR = 16;  ///< Default bound on the prediction error, in positions
+
+private:
+    /**
+     * @brief One linear piece: position ≈ firstPosition + slope * (key - firstKey)
+     */
+    struct Segment {
+        uint64_t firstKey;       ///< Smallest key covered by the segment
+        uint64_t firstPosition;  ///< Position of firstKey
+        double slope;            ///< Positions per key unit
+    };
+
+    static constexpr size_t SEGMENT_SIZE = 24;       ///< Serialized bytes per segment
+    static constexpr size_t HEADER_SIZE = 16;        ///< max error, segment count, key count
+
+    std::vector<Segment> segments;  ///< Segments in key order
+    uint64_t keyCount;              ///< Number of positions the model was fitted on
+    uint32_t maxError;              ///< Prediction error bound for fitted keys
+
+    /**
+     * @brief Predict the position of a key
+     * @param key The key
+     * @return A position in [0, keyCount]
+     */
+    size_t predict(uint64_t key) const {
+        auto next = std::upper_bound(segments.begin(), segments.end(), key,
+                                     [](uint64_t k, const Segment& s) { return k < s.firstKey; });
+        if (next == segments.begin()) {
+            return 0;
+        }
+        const Segment& segment = *std::prev(next);
+        double offset = segment.slope * static_cast<double>(key - segment.firstKey);
+        uint64_t limit = next == segments.end() ? keyCount : next->firstPosition;
+        uint64_t position = segment.firstPosition + static_cast<uint64_t>(offset + 0.5);
+        return static_cast<size_t>(std::min(position, limit));
+    }
+
+public:
+    /**
+     * @brief Constructor (empty model)
+     */
+    LearnedIndex() : keyCount(0), maxError(DEFAULT_MAX_ERROR) {}
+
+    /**
+     * @brief Fit the model to sorted keys
+     *
+     * Segments are grown greedily: each keeps the range of slopes that
+     * predicts all of its keys within the bound, and a new segment starts
+     * when that range becomes empty. Repeated keys are fitted at their
+     * first position.
+     * @param count Number of keys
+     * @param keyAt Function returning the key at a position (non-decreasing)
+     * @param error Bound on the prediction error, in positions
+     */
+    template <typename KeyAt>
+    void fit(size_t count, KeyAt keyAt, uint32_t error = DEFAULT_MAX_ERROR) {
+        segments.clear();
+        keyCount = count;
+        maxError = error;
+
+        size_t start = 0;
+        while (start < count) {
+            Segment segment{keyAt(start), start, 0.0};
+            double low = 0.0, high = -1.0;  // high < low: no constraint yet
+            uint64_t lastKey = segment.firstKey;
+            size_t position = start + 1;
+            for (; position < count; position++) {
+                uint64_t key = keyAt(position);
+                if (key == lastKey) {
+                    continue;
+                }
+                double span = static_cast<double>(key - segment.firstKey);
+                double pointLow = (static_cast<double>(position - start) - error) / span;
+                double pointHigh = (static_cast<double>(position - start) + error) / span;
+                if (high < low) {
+                    low = std::max(0.0, pointLow);
+                    high = pointHigh;
+                } else if (pointLow > high || pointHigh < low) {
+                    break;
+                } else {
+                    low = std::max(low, pointLow);
+                    high = std::min(high, pointHigh);
+                }
+                lastKey = key;
+            }
+            segment.slope = high < low ? 0.0 : (low + high) / 2;
+            segments.push_back(segment);
+            start = position;
+        }
+    }
+
+    /**
+     * @brief Find the first position whose key is not less than a key
+     *
+     * The search starts from the model's window and widens it if the keys
+     * have changed since fitting, so the result is always exact.
+     * @param key The key to search for
+     * @param keyAt Function returning the key at a position (the keys the model was fitted on)
+     * @return The position, or size() if every key is less than key
+     */
+    template <typename KeyAt>
+    size_t lowerBound(uint64_t key, KeyAt keyAt) const {
+        if (keyCount == 0) {
+            return 0;
+        }
+        size_t position = predict(key);
+        size_t window = maxError + 2;
+        size_t low = position > window ? position - window : 0;
+        size_t high = std::min<size_t>(keyCount, position + window);
+
+        while (low > 0 && keyAt(low - 1) >= key) {
+            low = low > window ? low - window : 0;
+            window *= 2;
+        }
+        while (high < keyCount && keyAt(high - 1) < key) {
+            high = std::min<size_t>(keyCount, high + window);
+            window *= 2;
+        }
+
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (keyAt(middle) < key) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    /**
+     * @brief Append the model to a byte buffer (little-endian)
+     * @param out Buffer to append to
+     */
+    void serialize(std::string& out) const {
+        size_t offset = out.size();
+        out.resize(offset + HEADER_SIZE + segments.size() * SEGMENT_SIZE);
+        char* data = &out[offset];
+        putLE(data, maxError, 4);
+        putLE(data + 4, segments.size(), 4);
+        putLE(data + 8, keyCount, 8);
+        data += HEADER_SIZE;
+        for (const auto& segment : segments) {
+            uint64_t slopeBits;
+            std::memcpy(&slopeBits, &segment.slope, sizeof(slopeBits));
+            putLE(data, segment.firstKey, 8);
+            putLE(data + 8, segment.firstPosition, 8);
+            putLE(data + 16, slopeBits, 8);
+            data += SEGMENT_SIZE;
+        }
+    }
+
+    /**
+     * @brief Read a model written by serialize
+     * @param data Start of the serialized model
+     * @param size Bytes available
+     * @return true if successful, false if the bytes are not a complete model
+     */
+    bool deserialize(const char* data, size_t size) {
+        segments.clear();
+        keyCount = 0;
+        if (size < HEADER_SIZE) {
+            return false;
+        }
+        uint32_t error = static_cast<uint32_t>(getLE(data, 4));
+        uint64_t count = getLE(data + 4, 4);
+        if ((size - HEADER_SIZE) / SEGMENT_SIZE < count) {
+            return false;
+        }
+
+        segments.resize(count);
+        const char* in = data + HEADER_SIZE;
+        for (auto& segment : segments) {
+            uint64_t slopeBits = getLE(in + 16, 8);
+            segment.firstKey = getLE(in, 8);
+            segment.firstPosition = getLE(in + 8, 8);
+            std::memcpy(&segment.slope, &slopeBits, sizeof(slopeBits));
+            in += SEGMENT_SIZE;
+        }
+        maxError = error;
+        keyCount = getLE(data + 8, 8);
+        return true;
+    }
+
+    /**
+     * @brief Get the number of bytes serialize writes
+     * @return The serialized size
+     */
+    size_t serializedSize() const { return HEADER_SIZE + segments.size() * SEGMENT_SIZE; }
+
+    /**
+     * @brief Check that the model was fitted on a set of keys
+     *
+     * Compares the key count and the first key of every segment, which
+     * catches a model left over from an older index.
+     * @param count Number of keys
+     * @param keyAt Function returning the key at a position
+     * @return true if the model matches the keys
+     */
+    template <typename KeyAt>
+    bool matches(size_t count, KeyAt keyAt) const {
+        if (count != keyCount || (count > 0 && segments.empty())) {
+            return false;
+        }
+        for (const auto& segment : segments) {
+            if (segment.firstPosition >= count || keyAt(segment.firstPosition) != segment.firstKey) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Get the number of positions the model covers
+     * @return The key count
+     */
+    uint64_t size() const { return keyCount; }
+
+    /**
+     * @brief Get the number of linear segments
+     * @return The segment count
+     */
+    size_t segmentCount() const { return segments.size(); }
+
+    /**
+     * @brief Get the prediction error bound
+     * @return The bound, in positions
+     */
+    uint32_t getMaxError() const { return maxError; }
+
+    /**
+     * @brief Get the memory held by the model
+     * @return Bytes used by the segments
+     */
+    size_t memoryUsage() const { return segments.capacity() * sizeof(Segment); }
+};
+
+#endif // LEARNED_INDEX_H
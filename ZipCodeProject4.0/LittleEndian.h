@@ -0,0 +1,88 @@
+/**
+ * @file LittleEndian.h
+ * @brief Little-endian integer and double fields for the binary file formats
+ *
+ * The binary index, tree, table and record formats all store their fields
+ * little-endian, byte by byte, so the files read the same on any host.
+ */
+
+#ifndef LITTLE_ENDIAN_H
+#define LITTLE_ENDIAN_H
+
+#include <string>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Store the low bytes of a value little-endian
+ * @param out Destination (at least bytes long)
+ * @param value The value to store
+ * @param bytes Number of bytes to store (1 to 8)
+ */
+inline void putLE(char* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out[i] = static_cast<char>(value >> (8 * i));
+    }
+}
+
+/**
+ * @brief Append the low bytes of a value little-endian
+ * @param out The string to append to
+ * @param value The value to store
+ * @param bytes Number of bytes to store (1 to 8)
+ */
+inline void appendLE(std::string& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+/**
+ * @brief Load a little-endian value
+ * @param in Source (at least bytes long)
+ * @param bytes Number of bytes to load (1 to 8)
+ * @return The value, zero extended
+ */
+inline uint64_t getLE(const char* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief Store a double as its 8 IEEE 754 bytes, little-endian
+ * @param out Destination (at least 8 bytes)
+ * @param value The value to store
+ */
+inline void putDoubleLE(char* out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putLE(out, bits, 8);
+}
+
+/**
+ * @brief Append a double as its 8 IEEE 754 bytes, little-endian
+ * @param out The string to append to
+ * @param value The value to store
+ */
+inline void appendDoubleLE(std::string& out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    appendLE(out, bits, 8);
+}
+
+/**
+ * @brief Load a double stored by putDoubleLE or appendDoubleLE
+ * @param in Source (at least 8 bytes)
+ * @return The value
+ */
+inline double getDoubleLE(const char* in) {
+    uint64_t bits = getLE(in, 8);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+#endif // LITTLE_ENDIAN_H
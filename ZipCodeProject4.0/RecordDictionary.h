@@ -0,0 +1,180 @@
+/**
+ * @file RecordDictionary.h
+ * @brief Definition of the RecordDictionary class for dictionary-encoded string fields
+ */
+
+#ifndef RECORD_DICTIONARY_H
+#define RECORD_DICTIONARY_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <cstdint>
+#include "Arena.h"
+
+/**
+ * @brief String columns that are dictionary encoded
+ */
+enum DictionaryColumn {
+    DICT_CITY = 0,      ///< City name
+    DICT_STATE = 1,     ///< State name
+    DICT_COUNTY = 2,    ///< County name
+    DICT_COLUMN_COUNT = 3
+};
+
+/**
+ * @class RecordDictionary
+ * @brief File-level dictionary mapping city, state and county strings to small integer codes
+ *
+ * Codes are assigned in first-seen order and never change, so records
+ * already written stay valid as the dictionary grows. String bytes live in
+ * an arena, so the dictionary allocates per chunk rather than per string.
+ */
+class RecordDictionary {
+private:
+    MonotonicArena arena;                               ///< Storage for the string bytes
+    std::vector<std::string_view> values[DICT_COLUMN_COUNT]; ///< Strings by code (views into arena)
+    std::unordered_map<std::string_view, uint32_t> codes[DICT_COLUMN_COUNT]; ///< Code by string
+    bool dirty;                                         ///< Whether codes were added since load/save
+
+public:
+    /**
+     * @brief Constructor
+     */
+    RecordDictionary() : dirty(false) {}
+
+    RecordDictionary(const RecordDictionary&) = delete;
+    RecordDictionary& operator=(const RecordDictionary&) = delete;
+
+    /**
+     * @brief Get the code for a string, adding it if new
+     * @param column The column
+     * @param value The string
+     * @return The code
+     */
+    uint32_t encode(DictionaryColumn column, std::string_view value) {
+        auto it = codes[column].find(value);
+        if (it != codes[column].end()) {
+            return it->second;
+        }
+        uint32_t code = values[column].size();
+        values[column].push_back(arena.copy(value));
+        codes[column].emplace(values[column].back(), code);
+        dirty = true;
+        return code;
+    }
+
+    /**
+     * @brief Look up the code for a string without adding it
+     * @param column The column
+     * @param value The string
+     * @param code Output parameter for the code
+     * @return true if the string is in the dictionary, false otherwise
+     */
+    bool find(DictionaryColumn column, std::string_view value, uint32_t& code) const {
+        auto it = codes[column].find(value);
+        if (it == codes[column].end()) {
+            return false;
+        }
+        code = it->second;
+        return true;
+    }
+
+    /**
+     * @brief Get the string for a code
+     * @param column The column
+     * @param code The code
+     * @return The string, or an empty view if the code is unknown
+     */
+    std::string_view decode(DictionaryColumn column, uint32_t code) const {
+        if (code >= values[column].size()) {
+            return std::string_view();
+        }
+        return values[column][code];
+    }
+
+    /**
+     * @brief Get the number of distinct strings in a column
+     * @param column The column
+     * @return The number of codes
+     */
+    int size(DictionaryColumn column) const { return values[column].size(); }
+
+    /**
+     * @brief Load the dictionary from its file
+     * @param fileName Name of the dictionary file
+     * @return true if successful, false otherwise
+     */
+    bool load(const std::string& fileName) {
+        std::ifstream file(fileName, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        clear();
+        for (int c = 0; c < DICT_COLUMN_COUNT; c++) {
+            uint32_t count = 0;
+            file.read(reinterpret_cast<char*>(&count), sizeof(count));
+            values[c].reserve(count);
+            codes[c].reserve(count);
+            for (uint32_t i = 0; i < count && file; i++) {
+                uint32_t len = 0;
+                file.read(reinterpret_cast<char*>(&len), sizeof(len));
+                char* bytes = static_cast<char*>(arena.allocate(len, 1));
+                file.read(bytes, len);
+                values[c].emplace_back(bytes, len);
+                codes[c].emplace(values[c].back(), i);
+            }
+        }
+
+        dirty = false;
+        return !file.fail();
+    }
+
+    /**
+     * @brief Save the dictionary to its file
+     * @param fileName Name of the dictionary file
+     * @return true if successful, false otherwise
+     */
+    bool save(const std::string& fileName) {
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        for (int c = 0; c < DICT_COLUMN_COUNT; c++) {
+            uint32_t count = values[c].size();
+            file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            for (const auto& value : values[c]) {
+                uint32_t len = value.size();
+                file.write(reinterpret_cast<const char*>(&len), sizeof(len));
+                file.write(value.data(), len);
+            }
+        }
+
+        dirty = false;
+        return file.good();
+    }
+
+    /**
+     * @brief Remove all strings
+     */
+    void clear() {
+        for (int c = 0; c < DICT_COLUMN_COUNT; c++) {
+            values[c].clear();
+            codes[c].clear();
+        }
+        arena.release();
+        dirty = true;
+    }
+
+    /**
+     * @brief Check if the dictionary has unsaved codes
+     * @return true if save() is needed
+     */
+    bool isDirty() const { return dirty; }
+};
+
+#endif // RECORD_DICTIONARY_H
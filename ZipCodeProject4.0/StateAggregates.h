@@ -0,0 +1,324 @@
+/**
+ * @file StateAggregates.h
+ * @brief Definition of the StateAggregates class, per-state summaries kept up to date with the sequence set
+ *
+ * Each state's record count, coordinate sums (for the centroid) and
+ * latitude/longitude extremes with their Zip Codes are updated as records
+ * are inserted and removed, so a summary is read without scanning the file.
+ * Counts and sums are exact under removal; an extreme is not, so removing
+ * the record that holds one marks the state stale until it is recomputed.
+ * The summaries are persisted to a sidecar file by save().
+ */
+
+#ifndef STATE_AGGREGATES_H
+#define STATE_AGGREGATES_H
+
+#include <string>
+#include <string_view>
+#include <map>
+#include <fstream>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @class StateAggregates
+ * @brief Summaries of every state's records, keyed by state abbreviation
+ */
+class StateAggregates {
+public:
+    /**
+     * @brief One latitude or longitude extreme and the record holding it
+     */
+    struct Extreme {
+        double value = 0.0;     ///< Coordinate in degrees
+        std::string zipCode;    ///< Zip Code of the record (the smallest one on ties)
+    };
+
+    /**
+     * @brief Summary of one state's records
+     */
+    struct Summary {
+        std::string state;              ///< State abbreviation
+        uint64_t count = 0;             ///< Number of records
+        int64_t latitudeSum = 0;        ///< Sum of latitudes in millionths of a degree
+        int64_t longitudeSum = 0;       ///< Sum of longitudes in millionths of a degree
+        Extreme minLatitude;            ///< Southernmost record
+        Extreme maxLatitude;            ///< Northernmost record
+        Extreme minLongitude;           ///< Westernmost record (least longitude)
+        Extreme maxLongitude;           ///< Easternmost record (greatest longitude)
+        bool stale = false;             ///< Whether an extreme was removed since the last recompute
+
+        /**
+         * @brief Get the mean latitude of the state's records
+         * @return The centroid latitude in degrees
+         */
+        double centroidLatitude() const { return count ? latitudeSum / 1e6 / count : 0.0; }
+
+        /**
+         * @brief Get the mean longitude of the state's records
+         * @return The centroid longitude in degrees
+         */
+        double centroidLongitude() const { return count ? longitudeSum / 1e6 / count : 0.0; }
+    };
+
+private:
+    static constexpr char MAGIC[8] = {'Z', 'I', 'P', 'S', 'T', 'A', 'T', 'E'};
+    static constexpr uint32_t VERSION = 1;
+
+    std::map<std::string, Summary, std::less<>> states;  ///< Summary of each state with records
+    bool loaded;                                         ///< Whether the summaries reflect the data file
+    bool dirty;                                          ///< Whether the summaries changed since load/save
+
+    static int64_t toMicros(double degrees) { return std::llround(degrees * 1e6); }
+
+    /**
+     * @brief Replace an extreme if a record beats it
+     * @param smaller true if the smaller coordinate wins
+     */
+    static void offer(Extreme& extreme, bool first, double value, std::string_view zipCode, bool smaller) {
+        if (!first) {
+            bool beaten = value == extreme.value ? zipCode >= extreme.zipCode : (value < extreme.value) != smaller;
+            if (beaten) {
+                return;
+            }
+        }
+        extreme.value = value;
+        extreme.zipCode.assign(zipCode.data(), zipCode.size());
+    }
+
+    static void writeString(std::ofstream& file, const std::string& value) {
+        uint32_t length = value.size();
+        file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        file.write(value.data(), length);
+    }
+
+    static bool readString(std::ifstream& file, std::string& value) {
+        uint32_t length = 0;
+        if (!file.read(reinterpret_cast<char*>(&length), sizeof(length)) || length > 256) {
+            return false;
+        }
+        value.resize(length);
+        return static_cast<bool>(file.read(&value[0], length));
+    }
+
+    template <typename T>
+    static void writeValue(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    static bool readValue(std::ifstream& file, T& value) {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+public:
+    /**
+     * @brief Constructor (not loaded)
+     */
+    StateAggregates() : loaded(false), dirty(false) {}
+
+    /**
+     * @brief Start empty summaries for a new or rescanned file
+     */
+    void clear() {
+        states.clear();
+        loaded = true;
+        dirty = true;
+    }
+
+    /**
+     * @brief Forget the summaries, e.g. when another file is opened
+     */
+    void unload() {
+        states.clear();
+        loaded = false;
+        dirty = false;
+    }
+
+    /**
+     * @brief Fold an inserted record into its state's summary
+     * @param state State abbreviation
+     * @param zipCode Zip Code
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     */
+    void add(std::string_view state, std::string_view zipCode, double latitude, double longitude) {
+        auto it = states.find(state);
+        if (it == states.end()) {
+            it = states.emplace(std::string(state), Summary()).first;
+            it->second.state = it->first;
+        }
+        accumulate(it->second, zipCode, latitude, longitude);
+        dirty = true;
+    }
+
+    /**
+     * @brief Take a removed record out of its state's summary
+     *
+     * The count and centroid stay exact. If the record held an extreme,
+     * the state is marked stale, since the next extreme is not known.
+     * @param state State abbreviation
+     * @param zipCode Zip Code
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     */
+    void remove(std::string_view state, std::string_view zipCode, double latitude, double longitude) {
+        auto it = states.find(state);
+        if (it == states.end()) {
+            return;
+        }
+        Summary& summary = it->second;
+        if (--summary.count == 0) {
+            states.erase(it);
+        } else {
+            summary.latitudeSum -= toMicros(latitude);
+            summary.longitudeSum -= toMicros(longitude);
+            if (zipCode == summary.minLatitude.zipCode || zipCode == summary.maxLatitude.zipCode ||
+                zipCode == summary.minLongitude.zipCode || zipCode == summary.maxLongitude.zipCode) {
+                summary.stale = true;
+            }
+        }
+        dirty = true;
+    }
+
+    /**
+     * @brief Replace a state's summary with one recomputed from its records
+     * @param summary The recomputed summary (state must be set; a count of 0 removes the state)
+     */
+    void replace(const Summary& summary) {
+        if (summary.count == 0) {
+            states.erase(summary.state);
+        } else {
+            states[summary.state] = summary;
+            states[summary.state].stale = false;
+        }
+        dirty = true;
+    }
+
+    /**
+     * @brief Build a summary from records one at a time, for replace()
+     * @param summary Summary being built (start from one with only the state set)
+     */
+    static void accumulate(Summary& summary, std::string_view zipCode, double latitude, double longitude) {
+        bool first = summary.count == 0;
+        summary.count++;
+        summary.latitudeSum += toMicros(latitude);
+        summary.longitudeSum += toMicros(longitude);
+        offer(summary.minLatitude, first, latitude, zipCode, true);
+        offer(summary.maxLatitude, first, latitude, zipCode, false);
+        offer(summary.minLongitude, first, longitude, zipCode, true);
+        offer(summary.maxLongitude, first, longitude, zipCode, false);
+    }
+
+    /**
+     * @brief Get a state's summary
+     * @param state State abbreviation
+     * @return The summary, or nullptr if the state has no records
+     */
+    const Summary* find(std::string_view state) const {
+        auto it = states.find(state);
+        return it == states.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * @brief Get every state's summary
+     * @return The summaries, in state order
+     */
+    const std::map<std::string, Summary, std::less<>>& getStates() const { return states; }
+
+    /**
+     * @brief Load the summaries from their sidecar file
+     * @param fileName Name of the summaries file
+     * @return true if successful, false if the file is missing or invalid
+     */
+    bool load(const std::string& fileName) {
+        unload();
+        std::ifstream file(fileName, std::ios::binary);
+        char magic[sizeof(MAGIC)];
+        uint32_t version = 0;
+        uint32_t count = 0;
+        if (!file.read(magic, sizeof(magic)) || std::string_view(magic, sizeof(magic)) !=
+                                                    std::string_view(MAGIC, sizeof(MAGIC)) ||
+            !readValue(file, version) || version != VERSION || !readValue(file, count)) {
+            return false;
+        }
+
+        for (uint32_t i = 0; i < count; i++) {
+            Summary summary;
+            uint8_t stale = 0;
+            bool ok = readString(file, summary.state) && readValue(file, summary.count) &&
+                      readValue(file, summary.latitudeSum) && readValue(file, summary.longitudeSum);
+            for (Extreme* extreme : {&summary.minLatitude, &summary.maxLatitude, &summary.minLongitude,
+                                     &summary.maxLongitude}) {
+                ok = ok && readValue(file, extreme->value) && readString(file, extreme->zipCode);
+            }
+            if (!ok || !readValue(file, stale)) {
+                states.clear();
+                return false;
+            }
+            summary.stale = stale != 0;
+            std::string state = summary.state;
+            states.emplace(std::move(state), std::move(summary));
+        }
+        loaded = true;
+        return true;
+    }
+
+    /**
+     * @brief Save the summaries to their sidecar file
+     * @param fileName Name of the summaries file
+     * @return true if successful, false otherwise
+     */
+    bool save(const std::string& fileName) {
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        file.write(MAGIC, sizeof(MAGIC));
+        writeValue(file, VERSION);
+        writeValue(file, static_cast<uint32_t>(states.size()));
+        for (const auto& entry : states) {
+            const Summary& summary = entry.second;
+            writeString(file, summary.state);
+            writeValue(file, summary.count);
+            writeValue(file, summary.latitudeSum);
+            writeValue(file, summary.longitudeSum);
+            for (const Extreme* extreme : {&summary.minLatitude, &summary.maxLatitude, &summary.minLongitude,
+                                           &summary.maxLongitude}) {
+                writeValue(file, extreme->value);
+                writeString(file, extreme->zipCode);
+            }
+            writeValue(file, static_cast<uint8_t>(summary.stale));
+        }
+        dirty = false;
+        return file.good();
+    }
+
+    /**
+     * @brief Check if the summaries reflect the data file
+     * @return true after clear() or a successful load()
+     */
+    bool isLoaded() const { return loaded; }
+
+    /**
+     * @brief Check if the summaries have unsaved changes
+     * @return true if save() is needed
+     */
+    bool isDirty() const { return dirty; }
+
+    /**
+     * @brief Check if any state needs its extremes recomputed
+     * @return true if some summary is stale
+     */
+    bool hasStale() const {
+        for (const auto& entry : states) {
+            if (entry.second.stale) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+#endif // STATE_AGGREGATES_H
@@ -0,0 +1,307 @@
+/**
+ * @file ZipKDTree.h
+ * @brief Definition of the ZipKDTree class, a persistent k-d tree for nearest-Zip-Code queries
+ *
+ * Each Zip Code's latitude/longitude is stored as a point on the unit
+ * sphere. Straight-line (chord) distance between such points orders them
+ * exactly as great-circle distance does, and a per-axis difference is a
+ * lower bound on it. A k-d tree over the 3-D points can therefore prune
+ * whole subtrees and answer k-nearest queries in O(log n) expected node
+ * visits, with no distortion near the poles or the date line.
+ *
+ * The tree is implicit: nodes are stored in one array where the node of
+ * the range [low, high) sits at its middle, so no child links are stored.
+ * The file is memory-mapped and read in place.
+ */
+
+#ifndef ZIP_KD_TREE_H
+#define ZIP_KD_TREE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <queue>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "MappedFile.h"
+#include "LittleEndian.h"
+#include "ZipDistances.h"
+
+/**
+ * @class ZipKDTree
+ * @brief Zip Code points with their block RBNs, searchable by great-circle distance
+ */
+class ZipKDTree {
+public:
+    static constexpr size_t MAX_ZIP_LENGTH = 8;           ///< Longest Zip Code key stored
+
+    /**
+     * @brief One search result
+     */
+    struct Neighbor {
+        std::string zipCode;  ///< Zip Code of the point
+        int rbn;              ///< RBN of the block holding the record
+        double distanceKm;    ///< Great-circle distance from the query point
+    };
+
+private:
+    /**
+     * @brief One point of the tree
+     */
+    struct Node {
+        double coords[3];            ///< Unit-sphere x, y, z
+        int32_t rbn;                 ///< RBN of the block holding the record
+        uint8_t axis;                ///< Axis this node splits on
+        char zip[MAX_ZIP_LENGTH];    ///< Zip Code, zero padded
+    };
+
+    static constexpr char MAGIC[8] = {'Z', 'I', 'P', 'K', 'D', 'T', 'R', 'E'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 24;  ///< magic, version, entry size, node count
+    static constexpr size_t ENTRY_SIZE = 40;   ///< x, y, z, rbn, axis, 3 pad bytes, zip
+
+    MappedFile mapped;        ///< Tree file, read in place after load()
+    std::vector<Node> nodes;  ///< Nodes of a tree built in memory (empty after load())
+    uint64_t nodeCount;       ///< Number of points
+
+    /**
+     * @brief Get a node from memory or from the mapped file
+     * @param position Position of the node in the implicit tree
+     * @return The node
+     */
+    Node nodeAt(size_t position) const {
+        if (!nodes.empty()) {
+            return nodes[position];
+        }
+        Node node;
+        const char* in = mapped.data() + HEADER_SIZE + position * ENTRY_SIZE;
+        for (int axis = 0; axis < 3; axis++) {
+            node.coords[axis] = getDoubleLE(in + axis * 8);
+        }
+        node.rbn = static_cast<int32_t>(getLE(in + 24, 4));
+        node.axis = static_cast<uint8_t>(in[28]);
+        std::memcpy(node.zip, in + 32, MAX_ZIP_LENGTH);
+        return node;
+    }
+
+    /**
+     * @brief Arrange nodes[low, high) into an implicit subtree
+     *
+     * Each subtree splits on the axis along which its points spread most,
+     * at the median, so the tree stays balanced.
+     */
+    void buildRange(size_t low, size_t high) {
+        if (high - low <= 1) {
+            if (high > low) {
+                nodes[low].axis = 0;
+            }
+            return;
+        }
+        double minimum[3] = {2, 2, 2}, maximum[3] = {-2, -2, -2};
+        for (size_t i = low; i < high; i++) {
+            for (int axis = 0; axis < 3; axis++) {
+                minimum[axis] = std::min(minimum[axis], nodes[i].coords[axis]);
+                maximum[axis] = std::max(maximum[axis], nodes[i].coords[axis]);
+            }
+        }
+        uint8_t axis = 0;
+        for (uint8_t a = 1; a < 3; a++) {
+            if (maximum[a] - minimum[a] > maximum[axis] - minimum[axis]) {
+                axis = a;
+            }
+        }
+
+        size_t middle = low + (high - low) / 2;
+        std::nth_element(nodes.begin() + low, nodes.begin() + middle, nodes.begin() + high,
+                         [axis](const Node& a, const Node& b) { return a.coords[axis] < b.coords[axis]; });
+        nodes[middle].axis = axis;
+        buildRange(low, middle);
+        buildRange(middle + 1, high);
+    }
+
+    using Candidate = std::pair<double, size_t>;  ///< Squared chord distance, node position
+
+    /**
+     * @brief Collect the k nearest nodes of the subtree [low, high)
+     * @param best Max-heap of the nearest nodes found so far, at most k long
+     */
+    void searchRange(size_t low, size_t high, const double (&point)[3], size_t k,
+                     std::priority_queue<Candidate>& best) const {
+        if (low >= high) {
+            return;
+        }
+        size_t middle = low + (high - low) / 2;
+        Node node = nodeAt(middle);
+
+        double squared = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            double delta = node.coords[axis] - point[axis];
+            squared += delta * delta;
+        }
+        if (best.size() < k) {
+            best.emplace(squared, middle);
+        } else if (squared < best.top().first) {
+            best.pop();
+            best.emplace(squared, middle);
+        }
+
+        // Search the side of the split holding the point first; the other side only if it can be closer
+        double split = point[node.axis] - node.coords[node.axis];
+        bool left = split < 0;
+        searchRange(left ? low : middle + 1, left ? middle : high, point, k, best);
+        if (best.size() < k || split * split < best.top().first) {
+            searchRange(left ? middle + 1 : low, left ? high : middle, point, k, best);
+        }
+    }
+
+public:
+    /**
+     * @brief Constructor (empty tree)
+     */
+    ZipKDTree() : nodeCount(0) {}
+
+    ZipKDTree(const ZipKDTree&) = delete;
+    ZipKDTree& operator=(const ZipKDTree&) = delete;
+
+    /**
+     * @brief Convert latitude/longitude to a point on the unit sphere
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     * @param point Output parameter for x, y, z
+     */
+    static void toPoint(double latitude, double longitude, double (&point)[3]) {
+        const double radians = M_PI / 180.0;
+        double phi = latitude * radians;
+        double lambda = longitude * radians;
+        point[0] = std::cos(phi) * std::cos(lambda);
+        point[1] = std::cos(phi) * std::sin(lambda);
+        point[2] = std::sin(phi);
+    }
+
+    /**
+     * @brief Start building a new tree (discards any loaded tree)
+     */
+    void clear() {
+        mapped.close();
+        nodes.clear();
+        nodeCount = 0;
+    }
+
+    /**
+     * @brief Add a point to a tree being built
+     * @param zipCode Zip Code of the record (longer keys are not indexed)
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     * @param rbn RBN of the block holding the record
+     * @return true if added, false if the Zip Code is too long to store
+     */
+    bool add(std::string_view zipCode, double latitude, double longitude, int rbn) {
+        if (zipCode.empty() || zipCode.size() > MAX_ZIP_LENGTH) {
+            return false;
+        }
+        Node node{};
+        toPoint(latitude, longitude, node.coords);
+        node.rbn = rbn;
+        std::memcpy(node.zip, zipCode.data(), zipCode.size());
+        nodes.push_back(node);
+        nodeCount = nodes.size();
+        return true;
+    }
+
+    /**
+     * @brief Arrange the added points into the tree; call once after the last add()
+     */
+    void build() {
+        buildRange(0, nodes.size());
+    }
+
+    /**
+     * @brief Write the tree to a file
+     * @param fileName Name of the tree file
+     * @return true if successful, false otherwise
+     */
+    bool save(const std::string& fileName) const {
+        std::string data(HEADER_SIZE + nodeCount * ENTRY_SIZE, '\0');
+        data.replace(0, sizeof(MAGIC), MAGIC, sizeof(MAGIC));
+        putLE(&data[8], VERSION, 4);
+        putLE(&data[12], ENTRY_SIZE, 4);
+        putLE(&data[16], nodeCount, 8);
+        for (size_t position = 0; position < nodeCount; position++) {
+            Node node = nodeAt(position);
+            char* out = &data[HEADER_SIZE + position * ENTRY_SIZE];
+            for (int axis = 0; axis < 3; axis++) {
+                putDoubleLE(out + axis * 8, node.coords[axis]);
+            }
+            putLE(out + 24, static_cast<uint32_t>(node.rbn), 4);
+            out[28] = static_cast<char>(node.axis);
+            std::memcpy(out + 32, node.zip, MAX_ZIP_LENGTH);
+        }
+
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        return file.is_open() && file.write(data.data(), data.size());
+    }
+
+    /**
+     * @brief Map a tree file for searching
+     * @param fileName Name of the tree file
+     * @return true if successful, false if the file is missing or not a valid tree
+     */
+    bool load(const std::string& fileName) {
+        clear();
+        if (!mapped.open(fileName)) {
+            return false;
+        }
+        const char* data = mapped.data();
+        if (mapped.size() < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 ||
+            getLE(data + 8, 4) != VERSION || getLE(data + 12, 4) != ENTRY_SIZE ||
+            (mapped.size() - HEADER_SIZE) / ENTRY_SIZE != getLE(data + 16, 8)) {
+            mapped.close();
+            return false;
+        }
+        nodeCount = getLE(data + 16, 8);
+        return true;
+    }
+
+    /**
+     * @brief Find the k points nearest to a location
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     * @param k Number of points wanted
+     * @return Up to k neighbors, nearest first
+     */
+    std::vector<Neighbor> nearest(double latitude, double longitude, size_t k) const {
+        std::vector<Neighbor> results;
+        if (k == 0 || nodeCount == 0) {
+            return results;
+        }
+        double point[3];
+        toPoint(latitude, longitude, point);
+        std::priority_queue<Candidate> best;
+        searchRange(0, nodeCount, point, k, best);
+
+        results.resize(best.size());
+        for (size_t i = results.size(); i-- > 0; best.pop()) {
+            Node node = nodeAt(best.top().second);
+            results[i] = Neighbor{std::string(node.zip, strnlen(node.zip, MAX_ZIP_LENGTH)), node.rbn,
+                                  ZipDistances::chordToKm(best.top().first)};
+        }
+        return results;
+    }
+
+    /**
+     * @brief Get the number of points in the tree
+     * @return The point count
+     */
+    uint64_t size() const { return nodeCount; }
+
+    /**
+     * @brief Check if the tree is available for searching
+     * @return true after load() or build()
+     */
+    bool isOpen() const { return !nodes.empty() || mapped.isOpen(); }
+};
+
+#endif // ZIP_KD_TREE_H
@@ -0,0 +1,244 @@
+/**
+ * @file ZipStore.cpp
+ * @brief Implementation of the ZipStore library interface over BSSManager
+ */
+
+#include "ZipStore.h"
+#include "BSSManager.h"
+#include <algorithm>
+#include <numeric>
+
+/**
+ * @brief Open store state hidden behind the ZipStore handle
+ */
+struct ZipStore::Impl {
+    BSSManager manager;   ///< Blocked sequence set holding the records
+
+    Impl(const std::string& dataFile, const std::string& indexFile) : manager(dataFile, indexFile) {
+        manager.setVerbose(false);
+    }
+};
+
+/**
+ * @brief Copy a stored record into the library's record type
+ */
+static void toStoreRecord(const ZipCodeRecord& in, ZipStoreRecord& out) {
+    out.zipCode = in.getZipCode();
+    out.placeName = in.getCityName();
+    out.state = in.getStateName();
+    out.county = in.getCountyName();
+    out.latitude = in.getLatitude();
+    out.longitude = in.getLongitude();
+}
+
+/**
+ * @brief Copy a state summary into the library's summary type
+ */
+static void toStoreSummary(const StateAggregates::Summary& in, ZipStoreStateSummary& out) {
+    out.state = in.state;
+    out.count = in.count;
+    out.centroidLatitude = in.centroidLatitude();
+    out.centroidLongitude = in.centroidLongitude();
+    out.northZip = in.maxLatitude.zipCode;
+    out.southZip = in.minLatitude.zipCode;
+    out.eastZip = in.maxLongitude.zipCode;
+    out.westZip = in.minLongitude.zipCode;
+}
+
+ZipStore::ZipStore() = default;
+
+ZipStore::~ZipStore() = default;
+
+ZipStore::ZipStore(ZipStore&& other) noexcept = default;
+
+ZipStore& ZipStore::operator=(ZipStore&& other) noexcept = default;
+
+/**
+ * @brief Open an existing store, replacing any store already open
+ */
+bool ZipStore::open(const std::string& dataFile, const std::string& indexFile) {
+    close();
+    auto opened = std::make_unique<Impl>(dataFile, indexFile);
+    if (!opened->manager.open()) {
+        return false;
+    }
+    impl = std::move(opened);
+    return true;
+}
+
+/**
+ * @brief Build a new store from a CSV file and keep it open
+ */
+bool ZipStore::create(const std::string& csvFile, const std::string& dataFile, const std::string& indexFile,
+                      const CreateOptions& options) {
+    close();
+    auto created = std::make_unique<Impl>(dataFile, indexFile);
+    if (!created->manager.initialize(options.blockSize, options.recordFormat, options.compression,
+                                     options.indexMode, options.layout) ||
+        !created->manager.createFromCSV(csvFile)) {
+        return false;
+    }
+    impl = std::move(created);
+    return true;
+}
+
+bool ZipStore::create(const std::string& csvFile, const std::string& dataFile, const std::string& indexFile) {
+    return create(csvFile, dataFile, indexFile, CreateOptions());
+}
+
+void ZipStore::close() {
+    impl.reset();
+}
+
+bool ZipStore::isOpen() const {
+    return impl != nullptr;
+}
+
+bool ZipStore::search(const std::string& zipCode, ZipStoreRecord& record) {
+    ZipCodeRecord found;
+    if (!impl || !impl->manager.search(zipCode, found)) {
+        return false;
+    }
+    toStoreRecord(found, record);
+    return true;
+}
+
+/**
+ * @brief Look up Zip Codes in key order and return the results in query order
+ */
+size_t ZipStore::searchBatch(const std::vector<std::string>& zipCodes, std::vector<ZipStoreRecord>& records,
+                             std::vector<bool>& found) {
+    records.assign(zipCodes.size(), ZipStoreRecord());
+    found.assign(zipCodes.size(), false);
+    if (!impl) {
+        return 0;
+    }
+
+    std::vector<size_t> order(zipCodes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return zipCodes[a] < zipCodes[b]; });
+
+    size_t count = 0;
+    ZipCodeRecord match;
+    for (size_t i : order) {
+        if (impl->manager.search(zipCodes[i], match)) {
+            toStoreRecord(match, records[i]);
+            found[i] = true;
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t ZipStore::range(const std::string& startZip, const std::string& endZip, std::vector<ZipStoreRecord>& records) {
+    records.clear();
+    if (!impl) {
+        return 0;
+    }
+    std::vector<ZipCodeRecord> matches;
+    impl->manager.rangeSearch(startZip, endZip, matches);
+    records.resize(matches.size());
+    for (size_t i = 0; i < matches.size(); i++) {
+        toStoreRecord(matches[i], records[i]);
+    }
+    return records.size();
+}
+
+size_t ZipStore::nearest(double latitude, double longitude, int k, std::vector<ZipStoreRecord>& records,
+                         std::vector<double>& distancesKm) {
+    records.clear();
+    distancesKm.clear();
+    if (!impl) {
+        return 0;
+    }
+    std::vector<ZipCodeRecord> matches;
+    impl->manager.nearest(latitude, longitude, k, matches, distancesKm);
+    records.resize(matches.size());
+    for (size_t i = 0; i < matches.size(); i++) {
+        toStoreRecord(matches[i], records[i]);
+    }
+    return records.size();
+}
+
+size_t ZipStore::withinRadius(double latitude, double longitude, double radiusKm, std::vector<ZipStoreRecord>& records,
+                              std::vector<double>& distancesKm) {
+    records.clear();
+    distancesKm.clear();
+    if (!impl) {
+        return 0;
+    }
+    std::vector<ZipCodeRecord> matches;
+    impl->manager.withinRadius(latitude, longitude, radiusKm, matches, distancesKm);
+    records.resize(matches.size());
+    for (size_t i = 0; i < matches.size(); i++) {
+        toStoreRecord(matches[i], records[i]);
+    }
+    return records.size();
+}
+
+size_t ZipStore::withinBox(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude,
+                           std::vector<ZipStoreRecord>& records) {
+    records.clear();
+    if (!impl) {
+        return 0;
+    }
+    std::vector<ZipCodeRecord> matches;
+    impl->manager.withinBox(minLatitude, minLongitude, maxLatitude, maxLongitude, matches);
+    records.resize(matches.size());
+    for (size_t i = 0; i < matches.size(); i++) {
+        toStoreRecord(matches[i], records[i]);
+    }
+    return records.size();
+}
+
+size_t ZipStore::distanceMatrix(const std::vector<std::string>& zipCodes, std::vector<ZipStoreRecord>& records,
+                                std::vector<double>& matrixKm) {
+    records.clear();
+    matrixKm.clear();
+    if (!impl) {
+        return 0;
+    }
+    std::vector<ZipCodeRecord> matches;
+    impl->manager.distanceMatrix(zipCodes, matches, matrixKm);
+    records.resize(matches.size());
+    for (size_t i = 0; i < matches.size(); i++) {
+        toStoreRecord(matches[i], records[i]);
+    }
+    return records.size();
+}
+
+bool ZipStore::stateSummary(const std::string& state, ZipStoreStateSummary& summary) {
+    StateAggregates::Summary found;
+    if (!impl || !impl->manager.getStateSummary(state, found)) {
+        return false;
+    }
+    toStoreSummary(found, summary);
+    return true;
+}
+
+size_t ZipStore::stateSummaries(std::vector<ZipStoreStateSummary>& summaries) {
+    summaries.clear();
+    if (!impl) {
+        return 0;
+    }
+    std::vector<StateAggregates::Summary> found;
+    impl->manager.getStateSummaries(found);
+    summaries.resize(found.size());
+    for (size_t i = 0; i < found.size(); i++) {
+        toStoreSummary(found[i], summaries[i]);
+    }
+    return summaries.size();
+}
+
+bool ZipStore::insert(const ZipStoreRecord& record) {
+    return impl && impl->manager.insert(ZipCodeRecord(record.zipCode, record.placeName, record.state,
+                                                      record.county, record.latitude, record.longitude));
+}
+
+bool ZipStore::remove(const std::string& zipCode) {
+    return impl && impl->manager.remove(zipCode);
+}
+
+int ZipStore::apiVersion() {
+    return ZIP_STORE_API_VERSION;
+}
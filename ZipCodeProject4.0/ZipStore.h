@@ -0,0 +1,240 @@
+/**
+ * @file ZipStore.h
+ * @brief Definition of the ZipStore class, the embeddable library interface to a Zip Code store
+ *
+ * This is the only header a program linking libzipstore needs. The storage
+ * classes stay behind an opaque handle, so their layout can change without
+ * recompiling callers; only the types declared here are part of the API.
+ * All operations report failure through their return values.
+ */
+
+#ifndef ZIP_STORE_H
+#define ZIP_STORE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#define ZIP_STORE_API_VERSION 2  ///< Incremented when the interface below changes incompatibly
+
+/**
+ * @struct ZipStoreRecord
+ * @brief One Zip Code record as returned by and passed to ZipStore
+ */
+struct ZipStoreRecord {
+    std::string zipCode;     ///< Zip Code
+    std::string placeName;   ///< City or place name
+    std::string state;       ///< State abbreviation
+    std::string county;      ///< County name
+    double latitude = 0.0;   ///< Latitude in degrees
+    double longitude = 0.0;  ///< Longitude in degrees
+};
+
+/**
+ * @struct ZipStoreStateSummary
+ * @brief Record count, centroid and extreme Zip Codes of one state
+ */
+struct ZipStoreStateSummary {
+    std::string state;               ///< State abbreviation
+    size_t count = 0;                ///< Number of records
+    double centroidLatitude = 0.0;   ///< Mean latitude in degrees
+    double centroidLongitude = 0.0;  ///< Mean longitude in degrees
+    std::string northZip;            ///< Zip Code with the greatest latitude
+    std::string southZip;            ///< Zip Code with the least latitude
+    std::string eastZip;             ///< Zip Code with the greatest longitude
+    std::string westZip;             ///< Zip Code with the least longitude
+};
+
+/**
+ * @class ZipStore
+ * @brief Handle to an open blocked sequence set Zip Code store
+ *
+ * A handle keeps its index and data file open between calls, so a lookup
+ * costs one block read instead of a process start. A handle may be moved
+ * but not copied, and must not be used from two threads at once.
+ */
+class ZipStore {
+public:
+    /**
+     * @brief Options for creating a new store
+     */
+    struct CreateOptions {
+        int blockSize = 512;                 ///< Block size in bytes
+        std::string recordFormat = "CSV";    ///< "CSV", "binary" or "dictionary"
+        std::string compression = "none";    ///< "none", "lz" or "zstd"
+        std::string indexMode = "blocks";    ///< "blocks", "direct" or "learned"
+        std::string layout = "zip";          ///< Block order: "zip" or "hilbert" (for spatial queries)
+    };
+
+    /**
+     * @brief Constructor (closed handle)
+     */
+    ZipStore();
+
+    /**
+     * @brief Destructor; closes the store
+     */
+    ~ZipStore();
+
+    ZipStore(ZipStore&& other) noexcept;
+    ZipStore& operator=(ZipStore&& other) noexcept;
+    ZipStore(const ZipStore&) = delete;
+    ZipStore& operator=(const ZipStore&) = delete;
+
+    /**
+     * @brief Open an existing store
+     * @param dataFile Name of the data file
+     * @param indexFile Name of the index file
+     * @return true if successful, false if the files are missing, invalid or from an older file version
+     */
+    bool open(const std::string& dataFile, const std::string& indexFile);
+
+    /**
+     * @brief Create a store from a CSV file of Zip Code records and open it
+     * @param csvFile Name of the CSV file (zip,place,state,county,lat,lon)
+     * @param dataFile Name of the data file to create
+     * @param indexFile Name of the index file to create
+     * @param options Block size, record format, compression, index mode and layout
+     * @return true if successful, false otherwise
+     */
+    bool create(const std::string& csvFile, const std::string& dataFile, const std::string& indexFile,
+                const CreateOptions& options);
+
+    /**
+     * @brief Create a store from a CSV file with default options and open it
+     * @param csvFile Name of the CSV file
+     * @param dataFile Name of the data file to create
+     * @param indexFile Name of the index file to create
+     * @return true if successful, false otherwise
+     */
+    bool create(const std::string& csvFile, const std::string& dataFile, const std::string& indexFile);
+
+    /**
+     * @brief Close the store (isOpen() becomes false)
+     */
+    void close();
+
+    /**
+     * @brief Check if the handle has an open store
+     * @return true after a successful open() or create()
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Find the record of a Zip Code
+     * @param zipCode The Zip Code
+     * @param record Output parameter for the record
+     * @return true if found, false otherwise
+     */
+    bool search(const std::string& zipCode, ZipStoreRecord& record);
+
+    /**
+     * @brief Find the records of many Zip Codes
+     *
+     * Lookups are made in key order, so queries that share a block read
+     * neighbouring data, but results are returned in query order.
+     * @param zipCodes The Zip Codes
+     * @param records Output parameter, one record per Zip Code (empty if not found)
+     * @param found Output parameter, whether each Zip Code was found
+     * @return The number of Zip Codes found
+     */
+    size_t searchBatch(const std::vector<std::string>& zipCodes, std::vector<ZipStoreRecord>& records,
+                       std::vector<bool>& found);
+
+    /**
+     * @brief Find all records in a Zip Code range
+     * @param startZip Smallest Zip Code in the range
+     * @param endZip Largest Zip Code in the range
+     * @param records Output parameter for the records, in store key order
+     * @return The number of records found
+     */
+    size_t range(const std::string& startZip, const std::string& endZip, std::vector<ZipStoreRecord>& records);
+
+    /**
+     * @brief Find the records nearest to a location by great-circle distance
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     * @param k Number of records wanted
+     * @param records Output parameter for the records, nearest first
+     * @param distancesKm Output parameter for each record's distance in km
+     * @return The number of records found
+     */
+    size_t nearest(double latitude, double longitude, int k, std::vector<ZipStoreRecord>& records,
+                   std::vector<double>& distancesKm);
+
+    /**
+     * @brief Find the records within a great-circle distance of a location
+     * @param latitude Latitude of the centre in degrees
+     * @param longitude Longitude of the centre in degrees
+     * @param radiusKm Radius in km
+     * @param records Output parameter for the records, nearest first
+     * @param distancesKm Output parameter for each record's distance in km
+     * @return The number of records found
+     */
+    size_t withinRadius(double latitude, double longitude, double radiusKm, std::vector<ZipStoreRecord>& records,
+                        std::vector<double>& distancesKm);
+
+    /**
+     * @brief Find the records inside a latitude/longitude box
+     * @param minLatitude Southern edge in degrees
+     * @param minLongitude Western edge in degrees (greater than maxLongitude if the box crosses the date line)
+     * @param maxLatitude Northern edge in degrees
+     * @param maxLongitude Eastern edge in degrees
+     * @param records Output parameter for the records
+     * @return The number of records found
+     */
+    size_t withinBox(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude,
+                     std::vector<ZipStoreRecord>& records);
+
+    /**
+     * @brief Get the great-circle distances between every pair of a list of Zip Codes
+     * @param zipCodes The Zip Codes; those not in the store are left out
+     * @param records Output parameter for the records found, in the order of zipCodes
+     * @param matrixKm Output parameter for the distances in km, row-major:
+     *                 matrixKm[i * records.size() + j] is the distance from records[i] to records[j]
+     * @return The number of records found
+     */
+    size_t distanceMatrix(const std::vector<std::string>& zipCodes, std::vector<ZipStoreRecord>& records,
+                          std::vector<double>& matrixKm);
+
+    /**
+     * @brief Get the summary of one state, kept up to date by insert and remove
+     * @param state State abbreviation
+     * @param summary Output parameter for the summary
+     * @return true if the state has records, false otherwise
+     */
+    bool stateSummary(const std::string& state, ZipStoreStateSummary& summary);
+
+    /**
+     * @brief Get the summaries of every state with records
+     * @param summaries Output parameter for the summaries, in state order
+     * @return The number of states
+     */
+    size_t stateSummaries(std::vector<ZipStoreStateSummary>& summaries);
+
+    /**
+     * @brief Insert a record
+     * @param record The record
+     * @return true if successful, false if the Zip Code exists or the store is not open
+     */
+    bool insert(const ZipStoreRecord& record);
+
+    /**
+     * @brief Remove the record of a Zip Code
+     * @param zipCode The Zip Code
+     * @return true if successful, false if not found
+     */
+    bool remove(const std::string& zipCode);
+
+    /**
+     * @brief Get the interface version the library was built with
+     * @return ZIP_STORE_API_VERSION of the library, to compare with the caller's
+     */
+    static int apiVersion();
+
+private:
+    struct Impl;                  ///< Storage classes, defined in ZipStore.cpp
+    std::unique_ptr<Impl> impl;   ///< Null while closed
+};
+
+#endif // ZIP_STORE_H